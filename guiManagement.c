@@ -3,11 +3,22 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
 
-#define MAX_STUDENTS 100
+#define INITIAL_CAPACITY 16
 #define MAX_NAME_LENGTH 50
 #define MAX_COURSE_LENGTH 50
 #define FILENAME "students.json"
+#define ROW_HEIGHT 30
+#define SCROLL_ROWS 3 // Rows moved per mouse wheel notch
+#define ROW_TEXT_LENGTH 160
+#define ROW_CACHE_SIZE 64 // Power of two, more than the rows visible at once
+#define READ_BUFFER_SIZE 16384
+#define WRITE_BUFFER_SIZE 65536
+#define RECORD_TEXT_LENGTH 1024 // One saved student with every name and course byte escaped as \u00XX
+#define MAX_JSON_DEPTH 64 // Nesting allowed inside values the loader skips
 
 typedef struct {
     int id;
@@ -16,21 +27,69 @@ typedef struct {
     float gpa;
 } Student;
 
-Student students[MAX_STUDENTS];
+// Growable store; capacity doubles so appends are amortized O(1)
+Student *students = NULL;
 int studentCount = 0;
+int studentCapacity = 0;
+
+// Formatted list rows, direct-mapped by row index. key is row + 1, or 0 when empty.
+typedef struct {
+    int key;
+    char text[ROW_TEXT_LENGTH];
+} CachedRow;
+
+CachedRow rowCache[ROW_CACHE_SIZE];
+bool listDirty = true; // The list texture no longer matches the students or the scroll offset
+
+// Buffered input for the streaming JSON loader
+typedef struct {
+    FILE *file;
+    size_t length;
+    size_t position;
+    char buffer[READ_BUFFER_SIZE];
+} JsonReader;
 
 // Function prototypes
 void DrawButton(Rectangle bounds, const char *text, Color color);
 bool IsButtonPressed(Rectangle bounds);
 void DrawInputField(Rectangle bounds, char *text, int *letterCount, int maxLetters, bool *focused);
+float ScrollStudentList(Rectangle bounds, float scroll);
+void DrawStudentList(RenderTexture2D target, Rectangle bounds, float scroll);
+const char *RowText(int row);
+void InvalidateRow(int row);
+void InvalidateAllRows(void);
+bool ReserveStudents(int needed);
 void AddStudent(const char *name, const char *course, float gpa);
 void DeleteStudent(int index);
 void SaveStudents(const char *filename);
+int FormatJsonString(char *out, const char *text);
+int FormatJsonNumber(char *out, float value);
 void LoadStudents(const char *filename);
+int PeekByte(JsonReader *reader);
+int NextByte(JsonReader *reader);
+int PeekToken(JsonReader *reader);
+int NextToken(JsonReader *reader);
+bool ReadHex4(JsonReader *reader, unsigned int *code);
+bool ReadJsonString(JsonReader *reader, char *out, int size);
+int TrimPartialUtf8(const char *text, int length);
+bool ReadJsonNumber(JsonReader *reader, double *value);
+bool SkipJsonValue(JsonReader *reader, int depth);
+bool ReadStudent(JsonReader *reader, Student *student);
+bool ReadStudentArray(JsonReader *reader);
+int LoadStudentsDom(const char *filename);
+void SaveStudentsDom(const char *filename);
+double SecondsNow(void);
+void BenchmarkJson(void);
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        BenchmarkJson();
+        return 0;
+    }
 
-int main() {
     InitWindow(800, 600, "Student Management System");
     SetTargetFPS(60);
+    EnableEventWaiting(); // Sleep in EndDrawing() until input arrives instead of redrawing at 60 FPS
 
     char nameInput[MAX_NAME_LENGTH] = "";
     char courseInput[MAX_COURSE_LENGTH] = "";
@@ -47,6 +106,9 @@ int main() {
     Rectangle deleteButton = {180, 220, 150, 30};
     Rectangle saveButton = {340, 220, 150, 30};
     Rectangle loadButton = {500, 220, 150, 30};
+    Rectangle listBounds = {20, 300, 760, 300};
+    float listScroll = 0; // Pixels of the list scrolled above listBounds
+    RenderTexture2D listTexture = LoadRenderTexture((int)listBounds.width, (int)listBounds.height);
 
     LoadStudents(FILENAME); // Load students from file at startup
 
@@ -108,16 +170,15 @@ int main() {
 
         // Display student list
         DrawText("Student List:", 20, 270, 20, BLACK);
-        for (int i = 0; i < studentCount; i++) {
-            char studentInfo[100];
-            sprintf(studentInfo, "%d. %s - %s (GPA: %.2f)", students[i].id, students[i].name, students[i].course, students[i].gpa);
-            DrawText(studentInfo, 20, 300 + i * 30, 20, BLACK);
-        }
+        listScroll = ScrollStudentList(listBounds, listScroll);
+        DrawStudentList(listTexture, listBounds, listScroll);
 
         EndDrawing();
     }
 
+    UnloadRenderTexture(listTexture);
     CloseWindow();
+    free(students);
     return 0;
 }
 
@@ -158,50 +219,506 @@ void DrawInputField(Rectangle bounds, char *text, int *letterCount, int maxLette
     DrawText(text, bounds.x + 5, bounds.y + 8, 20, MAROON);
 }
 
+// Apply the mouse wheel while the cursor is over the list and keep the offset in range
+float ScrollStudentList(Rectangle bounds, float scroll) {
+    float newScroll = scroll;
+    if (CheckCollisionPointRec(GetMousePosition(), bounds)) {
+        newScroll -= GetMouseWheelMove() * SCROLL_ROWS * ROW_HEIGHT;
+    }
+
+    float maxScroll = (float)studentCount * ROW_HEIGHT - bounds.height;
+    if (newScroll > maxScroll) newScroll = maxScroll;
+    if (newScroll < 0) newScroll = 0;
+    if (newScroll != scroll) listDirty = true;
+    return newScroll;
+}
+
+// Redraw the visible rows into target only when the list changed, then blit it.
+// Only rows inside bounds are drawn, so the cost does not grow with the number of students.
+void DrawStudentList(RenderTexture2D target, Rectangle bounds, float scroll) {
+    if (listDirty) {
+        int first = (int)(scroll / ROW_HEIGHT);
+        int last = (int)((scroll + bounds.height) / ROW_HEIGHT);
+        if (last > studentCount - 1) last = studentCount - 1;
+
+        BeginTextureMode(target);
+        ClearBackground(RAYWHITE);
+        for (int i = first; i <= last; i++) {
+            DrawText(RowText(i), 0, (int)(i * ROW_HEIGHT - scroll), 20, BLACK);
+        }
+
+        // Scroll bar thumb, sized by the fraction of the list in view
+        float contentHeight = (float)studentCount * ROW_HEIGHT;
+        if (contentHeight > bounds.height) {
+            float thumbHeight = bounds.height * bounds.height / contentHeight;
+            if (thumbHeight < 20) thumbHeight = 20;
+            float thumbY = scroll / (contentHeight - bounds.height) * (bounds.height - thumbHeight);
+            DrawRectangle((int)(bounds.width - 8), (int)thumbY, 6, (int)thumbHeight, GRAY);
+        }
+        EndTextureMode();
+        listDirty = false;
+    }
+
+    // Render textures are stored bottom-up, hence the negative source height
+    DrawTextureRec(target.texture, (Rectangle){0, 0, bounds.width, -bounds.height}, (Vector2){bounds.x, bounds.y}, WHITE);
+}
+
+// Formatted text for a row, built only when the row is not already cached
+const char *RowText(int row) {
+    CachedRow *cached = &rowCache[row & (ROW_CACHE_SIZE - 1)];
+    if (cached->key != row + 1) {
+        snprintf(cached->text, ROW_TEXT_LENGTH, "%d. %s - %s (GPA: %.2f)", students[row].id, students[row].name, students[row].course, students[row].gpa);
+        cached->key = row + 1;
+    }
+    return cached->text;
+}
+
+void InvalidateRow(int row) {
+    CachedRow *cached = &rowCache[row & (ROW_CACHE_SIZE - 1)];
+    if (cached->key == row + 1) cached->key = 0;
+    listDirty = true;
+}
+
+void InvalidateAllRows(void) {
+    memset(rowCache, 0, sizeof(rowCache));
+    listDirty = true;
+}
+
+// Make room for at least needed students
+bool ReserveStudents(int needed) {
+    if (needed <= studentCapacity) return true;
+
+    int capacity = studentCapacity ? studentCapacity : INITIAL_CAPACITY;
+    while (capacity < needed) capacity *= 2;
+    Student *temp = (Student *)realloc(students, capacity * sizeof(Student));
+    if (!temp) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    students = temp;
+    studentCapacity = capacity;
+    return true;
+}
+
 void AddStudent(const char *name, const char *course, float gpa) {
-    if (studentCount < MAX_STUDENTS) {
+    if (ReserveStudents(studentCount + 1)) {
         Student newStudent;
         newStudent.id = studentCount + 1;
-        strcpy(newStudent.name, name);
-        strcpy(newStudent.course, course);
+        snprintf(newStudent.name, MAX_NAME_LENGTH, "%s", name);
+        snprintf(newStudent.course, MAX_COURSE_LENGTH, "%s", course);
         newStudent.gpa = gpa;
-        students[studentCount++] = newStudent;
+        students[studentCount] = newStudent;
+        InvalidateRow(studentCount++);
     }
 }
 
+// Move the last student into the freed slot instead of shifting the rest down.
+// IDs stay 1..studentCount, so the moved student takes the deleted one's ID.
 void DeleteStudent(int index) {
     if (index >= 0 && index < studentCount) {
-        for (int i = index; i < studentCount - 1; i++) {
-            students[i] = students[i + 1];
-            students[i].id = i + 1;
-        }
         studentCount--;
+        if (index != studentCount) {
+            students[index] = students[studentCount];
+            students[index].id = index + 1;
+            InvalidateRow(index);
+        }
+        InvalidateRow(studentCount);
     }
 }
 
+// Stream the records straight to the file in the layout cJSON_Print used, so memory
+// stays constant however many students there are. Each record is formatted into a
+// local buffer and handed to stdio with one fwrite.
 void SaveStudents(const char *filename) {
-    cJSON *studentsJson = cJSON_CreateArray();
+    static const char courseKey[] = ",\n\t\t\"course\":\t";
+    static const char gpaKey[] = ",\n\t\t\"gpa\":\t";
+    static const char recordEnd[] = "\n\t}";
+    static char writeBuffer[WRITE_BUFFER_SIZE];
+    FILE *file = fopen(filename, "w");
+    if (!file) return;
+    setvbuf(file, writeBuffer, _IOFBF, sizeof(writeBuffer));
 
+    fputs("[", file);
     for (int i = 0; i < studentCount; i++) {
-        cJSON *studentJson = cJSON_CreateObject();
-        cJSON_AddNumberToObject(studentJson, "id", students[i].id);
-        cJSON_AddStringToObject(studentJson, "name", students[i].name);
-        cJSON_AddStringToObject(studentJson, "course", students[i].course);
-        cJSON_AddNumberToObject(studentJson, "gpa", students[i].gpa);
-        cJSON_AddItemToArray(studentsJson, studentJson);
+        char record[RECORD_TEXT_LENGTH];
+        int length = snprintf(record, sizeof(record), "%s{\n\t\t\"id\":\t%d,\n\t\t\"name\":\t", i ? ", " : "", students[i].id);
+        length += FormatJsonString(record + length, students[i].name);
+        memcpy(record + length, courseKey, sizeof(courseKey) - 1);
+        length += sizeof(courseKey) - 1;
+        length += FormatJsonString(record + length, students[i].course);
+        memcpy(record + length, gpaKey, sizeof(gpaKey) - 1);
+        length += sizeof(gpaKey) - 1;
+        length += FormatJsonNumber(record + length, students[i].gpa);
+        memcpy(record + length, recordEnd, sizeof(recordEnd) - 1);
+        length += sizeof(recordEnd) - 1;
+        fwrite(record, 1, length, file);
     }
+    fputs("]", file);
+    fclose(file);
+}
 
-    FILE *file = fopen(filename, "w");
-    if (file) {
-        char *jsonString = cJSON_Print(studentsJson);
-        fprintf(file, "%s", jsonString);
-        free(jsonString);
-        fclose(file);
+// Write text as a quoted JSON string into out, which needs room for six bytes per
+// character plus the quotes. Returns the length written.
+int FormatJsonString(char *out, const char *text) {
+    static const char hexDigits[] = "0123456789abcdef";
+    int length = 0;
+    out[length++] = '"';
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        char escape = 0;
+        switch (*c) {
+            case '"': escape = '"'; break;
+            case '\\': escape = '\\'; break;
+            case '\b': escape = 'b'; break;
+            case '\f': escape = 'f'; break;
+            case '\n': escape = 'n'; break;
+            case '\r': escape = 'r'; break;
+            case '\t': escape = 't'; break;
+        }
+
+        if (escape) {
+            out[length++] = '\\';
+            out[length++] = escape;
+        } else if (*c < 0x20) {
+            memcpy(out + length, "\\u00", 4);
+            out[length + 4] = hexDigits[*c >> 4];
+            out[length + 5] = hexDigits[*c & 0xF];
+            length += 6;
+        } else {
+            out[length++] = (char)*c;
+        }
     }
-    cJSON_Delete(studentsJson);
+    out[length++] = '"';
+    return length;
 }
 
+// Shortest text that reads back as the same float; JSON has no NaN or infinity.
+// out needs 32 bytes. Returns the length written.
+int FormatJsonNumber(char *out, float value) {
+    if (!isfinite(value)) {
+        memcpy(out, "null", 4);
+        return 4;
+    }
+
+    // Values with a few decimals, like every GPA typed in, are formatted from an integer
+    // without the round trip through strtof
+    static const double scales[] = {1, 10, 100, 1000, 10000};
+    for (int decimals = 0; decimals < 5; decimals++) {
+        double scaled = round(value * scales[decimals]);
+        if (fabs(scaled) < 1e7 && (float)(scaled / scales[decimals]) == value) {
+            long long whole = (long long)fabs(scaled);
+            long long unit = (long long)scales[decimals];
+            const char *sign = scaled < 0 ? "-" : "";
+            if (decimals == 0) return snprintf(out, 32, "%s%lld", sign, whole);
+            return snprintf(out, 32, "%s%lld.%0*lld", sign, whole / unit, decimals, whole % unit);
+        }
+    }
+
+    int length = 0;
+    for (int precision = 6; precision <= 9; precision++) {
+        length = snprintf(out, 32, "%.*g", precision, value);
+        if (strtof(out, NULL) == value) break;
+    }
+    return length;
+}
+
+// Parse the file in one pass straight into Student records. The records go into a
+// fresh store that replaces the current one only if the whole file parses.
 void LoadStudents(const char *filename) {
+    JsonReader reader;
+    reader.file = fopen(filename, "rb");
+    if (!reader.file) return;
+    reader.length = reader.position = 0;
+
+    Student *oldStudents = students;
+    int oldCount = studentCount;
+    int oldCapacity = studentCapacity;
+    students = NULL;
+    studentCount = studentCapacity = 0;
+
+    // Nothing but whitespace may follow the array
+    if (ReadStudentArray(&reader) && PeekToken(&reader) == EOF) {
+        free(oldStudents);
+        InvalidateAllRows();
+    } else {
+        free(students);
+        students = oldStudents;
+        studentCount = oldCount;
+        studentCapacity = oldCapacity;
+    }
+    fclose(reader.file);
+}
+
+int PeekByte(JsonReader *reader) {
+    if (reader->position == reader->length) {
+        reader->length = fread(reader->buffer, 1, READ_BUFFER_SIZE, reader->file);
+        reader->position = 0;
+        if (reader->length == 0) return EOF;
+    }
+    return (unsigned char)reader->buffer[reader->position];
+}
+
+int NextByte(JsonReader *reader) {
+    int c = PeekByte(reader);
+    if (c != EOF) reader->position++;
+    return c;
+}
+
+// Next byte that is not JSON whitespace, left in the stream
+int PeekToken(JsonReader *reader) {
+    int c = PeekByte(reader);
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        reader->position++;
+        c = PeekByte(reader);
+    }
+    return c;
+}
+
+int NextToken(JsonReader *reader) {
+    int c = PeekToken(reader);
+    if (c != EOF) reader->position++;
+    return c;
+}
+
+// Four hex digits of a \u escape
+bool ReadHex4(JsonReader *reader, unsigned int *code) {
+    *code = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = NextByte(reader);
+        if (digit >= '0' && digit <= '9') *code = *code * 16 + (digit - '0');
+        else if (digit >= 'a' && digit <= 'f') *code = *code * 16 + (digit - 'a' + 10);
+        else if (digit >= 'A' && digit <= 'F') *code = *code * 16 + (digit - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+// Read a quoted string into out, truncated to size - 1 bytes. out may be NULL to skip it.
+bool ReadJsonString(JsonReader *reader, char *out, int size) {
+    if (NextToken(reader) != '"') return false;
+
+    int length = 0;
+    for (;;) {
+        // Copy plain bytes straight from the buffer; escapes, the closing quote and
+        // buffer refills take the slow path below
+        while (reader->position < reader->length) {
+            unsigned char plain = (unsigned char)reader->buffer[reader->position];
+            if (plain == '"' || plain == '\\' || plain < 0x20) break;
+            if (out && length < size - 1) out[length++] = (char)plain;
+            reader->position++;
+        }
+
+        int c = NextByte(reader);
+        if (c == EOF || c < 0x20) return false;
+        if (c == '"') break;
+
+        char bytes[4];
+        int count = 1;
+        bytes[0] = (char)c;
+        if (c == '\\') {
+            c = NextByte(reader);
+            switch (c) {
+                case '"': case '\\': case '/': bytes[0] = (char)c; break;
+                case 'b': bytes[0] = '\b'; break;
+                case 'f': bytes[0] = '\f'; break;
+                case 'n': bytes[0] = '\n'; break;
+                case 'r': bytes[0] = '\r'; break;
+                case 't': bytes[0] = '\t'; break;
+                case 'u': {
+                    unsigned int code;
+                    if (!ReadHex4(reader, &code)) return false;
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        // High surrogate; the low half must follow as another \u escape
+                        unsigned int low;
+                        if (NextByte(reader) != '\\' || NextByte(reader) != 'u' || !ReadHex4(reader, &low)) return false;
+                        if (low < 0xDC00 || low > 0xDFFF) return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                        return false;
+                    }
+
+                    // Encode as UTF-8
+                    if (code < 0x80) {
+                        bytes[0] = (char)code;
+                    } else if (code < 0x800) {
+                        bytes[0] = (char)(0xC0 | (code >> 6));
+                        bytes[1] = (char)(0x80 | (code & 0x3F));
+                        count = 2;
+                    } else if (code < 0x10000) {
+                        bytes[0] = (char)(0xE0 | (code >> 12));
+                        bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        bytes[2] = (char)(0x80 | (code & 0x3F));
+                        count = 3;
+                    } else {
+                        bytes[0] = (char)(0xF0 | (code >> 18));
+                        bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                        bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                        bytes[3] = (char)(0x80 | (code & 0x3F));
+                        count = 4;
+                    }
+                    break;
+                }
+                default: return false;
+            }
+        }
+
+        if (out) {
+            for (int i = 0; i < count && length < size - 1; i++) {
+                out[length++] = bytes[i];
+            }
+        }
+    }
+
+    if (out) {
+        // A full buffer may end partway through a multi-byte character
+        if (length == size - 1) length = TrimPartialUtf8(out, length);
+        out[length] = '\0';
+    }
+    return true;
+}
+
+// Length of text without a multi-byte UTF-8 sequence cut off at its end
+int TrimPartialUtf8(const char *text, int length) {
+    int start = length;
+    while (start > 0 && length - start < 3 && ((unsigned char)text[start - 1] & 0xC0) == 0x80) start--;
+    if (start == 0) return length;
+
+    unsigned char lead = (unsigned char)text[start - 1];
+    int needed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    return length - (start - 1) < needed ? start - 1 : length;
+}
+
+bool ReadJsonNumber(JsonReader *reader, double *value) {
+    char text[64];
+    int length = 0;
+    int c = PeekToken(reader);
+    while ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+        if (length == (int)sizeof(text) - 1) return false;
+        text[length++] = (char)c;
+        reader->position++;
+        c = PeekByte(reader);
+    }
+    text[length] = '\0';
+
+    // Plain decimals such as ids and GPAs skip strtod: up to 15 digits are exact in a
+    // double, and dividing by an exact power of ten rounds correctly
+    static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                         1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char *digit = text[0] == '-' ? text + 1 : text;
+    double mantissa = 0;
+    int digits = 0;
+    int decimals = -1; // Digits after the point, or -1 before it
+    for (; *digit; digit++) {
+        if (*digit >= '0' && *digit <= '9') {
+            mantissa = mantissa * 10 + (*digit - '0');
+            digits++;
+            if (decimals >= 0) decimals++;
+        } else if (*digit == '.' && decimals < 0) {
+            decimals = 0;
+        } else {
+            break;
+        }
+    }
+    if (*digit == '\0' && digits > 0 && digits <= 15 && decimals != 0) {
+        if (text[0] == '-') mantissa = -mantissa;
+        *value = decimals > 0 ? mantissa / powersOfTen[decimals] : mantissa;
+        return true;
+    }
+
+    char *end;
+    *value = strtod(text, &end);
+    return length > 0 && *end == '\0';
+}
+
+// Consume a value of any type, for keys the loader does not use
+bool SkipJsonValue(JsonReader *reader, int depth) {
+    if (depth > MAX_JSON_DEPTH) return false;
+
+    int c = PeekToken(reader);
+    if (c == '"') return ReadJsonString(reader, NULL, 0);
+    if (c == '{' || c == '[') {
+        int close = c == '{' ? '}' : ']';
+        reader->position++;
+        if (PeekToken(reader) == close) {
+            reader->position++;
+            return true;
+        }
+        int next;
+        do {
+            if (c == '{' && (!ReadJsonString(reader, NULL, 0) || NextToken(reader) != ':')) return false;
+            if (!SkipJsonValue(reader, depth + 1)) return false;
+            next = NextToken(reader);
+        } while (next == ',');
+        return next == close;
+    }
+    const char *literal = c == 't' ? "true" : c == 'f' ? "false" : c == 'n' ? "null" : NULL;
+    if (literal) {
+        for (; *literal; literal++) {
+            if (NextByte(reader) != *literal) return false;
+        }
+        return true;
+    }
+    double number;
+    return ReadJsonNumber(reader, &number);
+}
+
+// Fill student from one {id, name, course, gpa} object. Missing fields stay empty.
+bool ReadStudent(JsonReader *reader, Student *student) {
+    memset(student, 0, sizeof(Student));
+    if (NextToken(reader) != '{') return false;
+    if (PeekToken(reader) == '}') {
+        reader->position++;
+        return true;
+    }
+
+    int c;
+    do {
+        char key[16];
+        double number;
+        if (!ReadJsonString(reader, key, sizeof(key)) || NextToken(reader) != ':') return false;
+
+        if (strcmp(key, "id") == 0) {
+            if (!ReadJsonNumber(reader, &number) || number < INT_MIN || number > INT_MAX) return false;
+            student->id = (int)number;
+        } else if (strcmp(key, "name") == 0) {
+            if (!ReadJsonString(reader, student->name, MAX_NAME_LENGTH)) return false;
+        } else if (strcmp(key, "course") == 0) {
+            if (!ReadJsonString(reader, student->course, MAX_COURSE_LENGTH)) return false;
+        } else if (strcmp(key, "gpa") == 0) {
+            if (PeekToken(reader) == 'n') {
+                if (!SkipJsonValue(reader, 0)) return false; // null, written for a NaN GPA
+            } else {
+                if (!ReadJsonNumber(reader, &number)) return false;
+                student->gpa = (float)number;
+            }
+        } else if (!SkipJsonValue(reader, 0)) {
+            return false;
+        }
+        c = NextToken(reader);
+    } while (c == ',');
+    return c == '}';
+}
+
+// Append every object of the top-level array to the store
+bool ReadStudentArray(JsonReader *reader) {
+    if (NextToken(reader) != '[') return false;
+    if (PeekToken(reader) == ']') {
+        reader->position++;
+        return true;
+    }
+
+    int c;
+    do {
+        if (!ReserveStudents(studentCount + 1) || !ReadStudent(reader, &students[studentCount])) return false;
+        studentCount++;
+        c = NextToken(reader);
+    } while (c == ',');
+    return c == ']';
+}
+
+// The cJSON loader, kept as the benchmark baseline. It walks the array with
+// cJSON_ArrayForEach; indexing with cJSON_GetArrayItem is quadratic and does not
+// finish at a million records.
+int LoadStudentsDom(const char *filename) {
     FILE *file = fopen(filename, "r");
     if (file) {
         fseek(file, 0, SEEK_END);
@@ -216,20 +733,93 @@ void LoadStudents(const char *filename) {
         cJSON *studentsJson = cJSON_Parse(jsonString);
         if (studentsJson) {
             studentCount = 0; // Reset student count before loading
-            int arraySize = cJSON_GetArraySize(studentsJson);
-            for (int i = 0; i < arraySize && studentCount < MAX_STUDENTS; i++) {
-                cJSON *studentJson = cJSON_GetArrayItem(studentsJson, i);
-                if (studentJson) {
-                    Student newStudent;
-                    newStudent.id = cJSON_GetObjectItem(studentJson, "id")->valueint;
-                    strcpy(newStudent.name, cJSON_GetObjectItem(studentJson, "name")->valuestring);
-                    strcpy(newStudent.course, cJSON_GetObjectItem(studentJson, "course")->valuestring);
-                    newStudent.gpa = (float)cJSON_GetObjectItem(studentJson, "gpa")->valuedouble;
-                    students[studentCount++] = newStudent;
-                }
+            cJSON *studentJson;
+            cJSON_ArrayForEach(studentJson, studentsJson) {
+                if (!ReserveStudents(studentCount + 1)) break;
+                Student newStudent;
+                newStudent.id = cJSON_GetObjectItem(studentJson, "id")->valueint;
+                snprintf(newStudent.name, MAX_NAME_LENGTH, "%s", cJSON_GetObjectItem(studentJson, "name")->valuestring);
+                snprintf(newStudent.course, MAX_COURSE_LENGTH, "%s", cJSON_GetObjectItem(studentJson, "course")->valuestring);
+                newStudent.gpa = (float)cJSON_GetObjectItem(studentJson, "gpa")->valuedouble;
+                students[studentCount++] = newStudent;
             }
             cJSON_Delete(studentsJson);
+            InvalidateAllRows();
         }
         free(jsonString);
     }
+    return studentCount;
+}
+
+double SecondsNow(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// The cJSON writer, kept as the benchmark baseline
+void SaveStudentsDom(const char *filename) {
+    cJSON *studentsJson = cJSON_CreateArray();
+
+    for (int i = 0; i < studentCount; i++) {
+        cJSON *studentJson = cJSON_CreateObject();
+        cJSON_AddNumberToObject(studentJson, "id", students[i].id);
+        cJSON_AddStringToObject(studentJson, "name", students[i].name);
+        cJSON_AddStringToObject(studentJson, "course", students[i].course);
+        cJSON_AddNumberToObject(studentJson, "gpa", students[i].gpa);
+        cJSON_AddItemToArray(studentsJson, studentJson);
+    }
+
+    FILE *file = fopen(filename, "w");
+    if (file) {
+        char *jsonString = cJSON_Print(studentsJson);
+        fprintf(file, "%s", jsonString);
+        free(jsonString);
+        fclose(file);
+    }
+    cJSON_Delete(studentsJson);
+}
+
+// Time the streaming writer and loader against cJSON on generated students
+void BenchmarkJson(void) {
+    static const char *courses[] = {"Computer Science", "Mathematics", "Physics", "History"};
+    const char *benchFile = "students_bench.json";
+    int sizes[] = {10000, 100000, 1000000};
+
+    for (int i = 0; i < 3; i++) {
+        studentCount = 0;
+        for (int j = 0; j < sizes[i]; j++) {
+            char name[MAX_NAME_LENGTH];
+            snprintf(name, sizeof(name), "Student %d", j + 1);
+            AddStudent(name, courses[j % 4], (j % 400) / 100.0f);
+        }
+
+        double start = SecondsNow();
+        SaveStudentsDom(benchFile);
+        double domSaveTime = SecondsNow() - start;
+
+        // Saved last, so the loaders below read the streaming writer's output
+        start = SecondsNow();
+        SaveStudents(benchFile);
+        double streamSaveTime = SecondsNow() - start;
+
+        start = SecondsNow();
+        LoadStudents(benchFile);
+        double streamTime = SecondsNow() - start;
+        int streamCount = studentCount;
+
+        start = SecondsNow();
+        int domCount = LoadStudentsDom(benchFile);
+        double domTime = SecondsNow() - start;
+
+        printf("%7d students: save streaming %8.1f ms, cJSON %8.1f ms\n",
+               sizes[i], streamSaveTime * 1e3, domSaveTime * 1e3);
+        printf("%7d students: load streaming %8.1f ms (%d loaded), cJSON DOM %8.1f ms (%d loaded)\n",
+               sizes[i], streamTime * 1e3, streamCount, domTime * 1e3, domCount);
+    }
+
+    remove(benchFile);
+    free(students);
+    students = NULL;
+    studentCount = studentCapacity = 0;
 }
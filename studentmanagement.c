@@ -2,174 +2,2040 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 int studentCount = 0;
+int studentCapacity = 0;
+int loadThreads = 1; // worker threads used by loadContent(); above 1 it reads the whole file, see --threads
+
+// The text save is a snapshot plus an append-only journal of created students.
+// persistedCount is how many leading students are already on disk, -1 when the files
+// on disk don't describe the roster in memory and the next save must write a snapshot.
+#define SNAPSHOT_FILENAME "student_data.txt"
+#define JOURNAL_FILENAME "student_data.journal"
+#define JOURNAL_COMPACT_MIN 1024
+int persistedCount = -1;
+int snapshotCount = 0;
+int journalEntries = 0;
 
 
 struct Student{
-char name[50]; 
+unsigned int name; // offset of the name in namePool
 int score;
 int ID;
 };
 
-struct Student* students;
+struct Student* students;
+
+// Names are interned: each distinct name is stored once, NUL-terminated, in namePool.
+// namePoolSlots is an open-addressing table of offset + 1 (0 for an empty slot) used
+// to find an existing copy. After a binary load the pool points into the file mapping
+// and the table is only built when the first new name is added.
+#define NAME_POOL_FAILED 0xFFFFFFFFu
+char* namePool = NULL;
+size_t namePoolLength = 0;
+size_t namePoolCapacity = 0;
+unsigned int* namePoolSlots = NULL;
+size_t namePoolSlotCount = 0;
+size_t namePoolStrings = 0;
+
+// The pool always ends in a terminator, so any offset inside it is a valid string.
+const char* studentName(int i){
+    return students[i].name < namePoolLength ? namePool + students[i].name : "";
+}
+
+// When the roster was opened from the binary save file, students points straight
+// into this read-only mapping until the first append copies it onto the heap.
+void* studentMapping = NULL;
+size_t studentMappingLength = 0;
+
+// Columnar copy of the scores for the aggregate commands, so a pass over the
+// scores streams 4 bytes per student instead of the whole record. It holds the
+// first columnCount students; ensureColumns() catches up after a mapped load.
+// ID lookups go through idIndex, so there is no ID column.
+int* scoreColumn = NULL;
+int columnCount = 0;
+int columnCapacity = 0;
+
+// Open-addressing hash table mapping a key hash to positions in students.
+// Each slot remembers the key's hash so probing only compares records on a hash hit.
+struct IndexSlot{
+    unsigned int hash;
+    int index; // position in students, -1 for an empty slot
+};
+
+struct HashIndex{
+    struct IndexSlot* slots;
+    int capacity;
+    int used;
+};
+
+struct HashIndex nameIndex = {NULL, 0, 0}; // keyed on the case-folded name
+struct HashIndex idIndex = {NULL, 0, 0};   // keyed on ID
+
+// Student positions ordered by score (ties in insertion order), for range and top queries.
+// New students are appended unsorted; ensureScoreOrder() sorts them and merges them in
+// before the next score query, so a create costs O(1) here instead of a memmove.
+int* scoreOrder = NULL;
+int scoreOrderCapacity = 0;
+int scoreOrderSorted = 0; // leading entries of scoreOrder that are in score order
+
+// Trigram index over the case-folded names for substring and prefix search. Names are
+// padded with two TRIGRAM_ANCHOR bytes in front so prefixes have trigrams of their own.
+// trigramIndex maps hashInt(trigram) (a bijection, so no separate key is kept) to a
+// posting list of student positions in ascending order.
+#define TRIGRAM_ANCHOR 1
+
+struct PostingList{
+    int* items;
+    int count;
+    int capacity;
+};
+
+struct HashIndex trigramIndex = {NULL, 0, 0};
+struct PostingList* postingLists = NULL;
+int postingListCount = 0;
+int postingListCapacity = 0;
+
+// Set when a bulk load skipped index maintenance; the indexes are rebuilt on the next query.
+int indexesStale = 0;
+
+// ASCII case-folding kernels used by every name comparison. main() picks the widest
+// implementation the CPU supports; the scalar versions are the portable fallback.
+size_t foldMismatchScalar(const char* a, const char* b, size_t length){
+    for(size_t i = 0; i < length; i++){
+        unsigned char x = (unsigned char)a[i];
+        unsigned char y = (unsigned char)b[i];
+        x = (x >= 'A' && x <= 'Z') ? x | 0x20 : x;
+        y = (y >= 'A' && y <= 'Z') ? y | 0x20 : y;
+        if(x != y){
+            return i;
+        }
+    }
+    return length;
+}
+
+void foldCopyScalar(char* dest, const char* src, size_t length){
+    for(size_t i = 0; i < length; i++){
+        unsigned char c = (unsigned char)src[i];
+        dest[i] = (char)((c >= 'A' && c <= 'Z') ? c | 0x20 : c);
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+// Bytes >= 0x80 compare as negative, so only 'A'..'Z' get the 0x20 bit set.
+static inline __attribute__((target("sse2")))
+__m128i foldSSE2(__m128i v){
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse2")))
+size_t foldMismatchSSE2(const char* a, const char* b, size_t length){
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16){
+        __m128i x = foldSSE2(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m128i y = foldSSE2(_mm_loadu_si128((const __m128i*)(b + i)));
+        unsigned int equal = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+        if(equal != 0xFFFFu){
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    return i + foldMismatchScalar(a + i, b + i, length - i);
+}
+
+__attribute__((target("sse2")))
+void foldCopySSE2(char* dest, const char* src, size_t length){
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16){
+        _mm_storeu_si128((__m128i*)(dest + i), foldSSE2(_mm_loadu_si128((const __m128i*)(src + i))));
+    }
+    foldCopyScalar(dest + i, src + i, length - i);
+}
+
+static inline __attribute__((target("avx2")))
+__m256i foldAVX2(__m256i v){
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+// The 16-byte and scalar tails are repeated here rather than calling the SSE2 kernel,
+// so the whole call stays VEX-encoded and avoids SSE/AVX transition stalls.
+__attribute__((target("avx2")))
+size_t foldMismatchAVX2(const char* a, const char* b, size_t length){
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32){
+        __m256i x = foldAVX2(_mm256_loadu_si256((const __m256i*)(a + i)));
+        __m256i y = foldAVX2(_mm256_loadu_si256((const __m256i*)(b + i)));
+        unsigned int equal = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if(equal != 0xFFFFFFFFu){
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    if(i + 16 <= length){
+        __m128i x = foldSSE2(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m128i y = foldSSE2(_mm_loadu_si128((const __m128i*)(b + i)));
+        unsigned int equal = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+        if(equal != 0xFFFFu){
+            return i + __builtin_ctz(~equal);
+        }
+        i += 16;
+    }
+    for(; i < length; i++){
+        unsigned char x = (unsigned char)a[i];
+        unsigned char y = (unsigned char)b[i];
+        x = (x >= 'A' && x <= 'Z') ? x | 0x20 : x;
+        y = (y >= 'A' && y <= 'Z') ? y | 0x20 : y;
+        if(x != y){
+            return i;
+        }
+    }
+    return length;
+}
+
+__attribute__((target("avx2")))
+void foldCopyAVX2(char* dest, const char* src, size_t length){
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32){
+        _mm256_storeu_si256((__m256i*)(dest + i), foldAVX2(_mm256_loadu_si256((const __m256i*)(src + i))));
+    }
+    if(i + 16 <= length){
+        _mm_storeu_si128((__m128i*)(dest + i), foldSSE2(_mm_loadu_si128((const __m128i*)(src + i))));
+        i += 16;
+    }
+    for(; i < length; i++){
+        unsigned char c = (unsigned char)src[i];
+        dest[i] = (char)((c >= 'A' && c <= 'Z') ? c | 0x20 : c);
+    }
+}
+#endif
+
+// Position of the first byte where a and b differ ignoring ASCII case, or length.
+size_t (*foldMismatch)(const char* a, const char* b, size_t length) = foldMismatchScalar;
+// Lowercases length bytes of src into dest.
+void (*foldCopy)(char* dest, const char* src, size_t length) = foldCopyScalar;
+const char* foldKernelName = "scalar";
+
+void selectFoldKernels(){
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        foldMismatch = foldMismatchAVX2;
+        foldCopy = foldCopyAVX2;
+        foldKernelName = "AVX2";
+    } else if(__builtin_cpu_supports("sse2")){
+        foldMismatch = foldMismatchSSE2;
+        foldCopy = foldCopySSE2;
+        foldKernelName = "SSE2";
+    }
+#endif
+}
+
+int namesEqualIgnoreCase(const char* a, const char* b){
+    size_t length = strlen(a);
+    return strlen(b) == length && foldMismatch(a, b, length) == length;
+}
+
+int startsWithIgnoreCase(const char* name, const char* key, size_t keyLength){
+    size_t nameLength = 0;
+    while(nameLength < keyLength && name[nameLength]){
+        nameLength++;
+    }
+    return nameLength == keyLength && foldMismatch(name, key, keyLength) == keyLength;
+}
+
+int containsIgnoreCase(const char* name, const char* key, size_t keyLength){
+    size_t nameLength = strlen(name);
+    for(size_t i = 0; i + keyLength <= nameLength; i++){
+        if(foldMismatch(name + i, key, keyLength) == keyLength){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+unsigned int hashFoldedName(const char* name){
+    // FNV-1a over the lowercased bytes, so "Ann" and "ANN" hash the same
+    unsigned int hash = 2166136261u;
+    char folded[64];
+    size_t length = strlen(name);
+    for(size_t start = 0; start < length; start += sizeof(folded)){
+        size_t n = length - start < sizeof(folded) ? length - start : sizeof(folded);
+        foldCopy(folded, name + start, n);
+        for(size_t i = 0; i < n; i++){
+            hash ^= (unsigned char)folded[i];
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+unsigned int hashInt(int value){
+    // murmur3 finalizer: a bijection that spreads sequential values over the whole table
+    unsigned int hash = (unsigned int)value;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+void placeIndexSlot(struct IndexSlot* slots, int capacity, struct IndexSlot slot){
+    int pos = slot.hash & (capacity - 1);
+    while(slots[pos].index != -1){
+        pos = (pos + 1) & (capacity - 1);
+    }
+    slots[pos] = slot;
+}
+
+int resizeHashIndex(struct HashIndex* table, int capacity){
+    struct IndexSlot* slots = (struct IndexSlot*)malloc(capacity * sizeof(struct IndexSlot));
+    if (slots == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 0;
+    }
+    for(int i = 0; i < capacity; i++){
+        slots[i].index = -1;
+    }
+    for(int i = 0; i < table->capacity; i++){
+        if(table->slots[i].index != -1){
+            placeIndexSlot(slots, capacity, table->slots[i]);
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return 1;
+}
+
+int insertHashIndex(struct HashIndex* table, unsigned int hash, int index){
+    // keep the load factor at or below one half so probe runs stay short
+    if((table->used + 1) * 2 > table->capacity){
+        int capacity = table->capacity ? table->capacity * 2 : 16;
+        if(!resizeHashIndex(table, capacity)){
+            return 0;
+        }
+    }
+    struct IndexSlot slot;
+    slot.hash = hash;
+    slot.index = index;
+    placeIndexSlot(table->slots, table->capacity, slot);
+    table->used++;
+    return 1;
+}
+
+void clearHashIndex(struct HashIndex* table, int expected){
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->used = 0;
+
+    int capacity = 16;
+    while(capacity < expected * 2){
+        capacity *= 2;
+    }
+    resizeHashIndex(table, capacity);
+}
+
+int reserveScoreOrder(int needed){
+    if(needed <= scoreOrderCapacity){
+        return 1;
+    }
+    int capacity = scoreOrderCapacity ? scoreOrderCapacity : 16;
+    while(capacity < needed){
+        capacity *= 2;
+    }
+    int* temp = (int*)realloc(scoreOrder, capacity * sizeof(int));
+    if(temp == NULL){
+        fprintf(stderr, "Memory reallocation failed\n");
+        return 0;
+    }
+    scoreOrder = temp;
+    scoreOrderCapacity = capacity;
+    return 1;
+}
+
+// First position in scoreOrder whose score is greater than (or, with inclusive set,
+// at least) the given score.
+int scoreBound(int count, int score, int inclusive){
+    int low = 0;
+    int high = count;
+    while(low < high){
+        int mid = low + (high - low) / 2;
+        int current = students[scoreOrder[mid]].score;
+        if(current < score || (!inclusive && current == score)){
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+int trigramAt(const char* padded, int pos){
+    return ((unsigned char)padded[pos] << 16) | ((unsigned char)padded[pos + 1] << 8) | (unsigned char)padded[pos + 2];
+}
+
+// Writes the anchored, lowercased name into padded and returns its length.
+int padFoldedName(const char* name, char* padded, int size){
+    int length = 0;
+    padded[length++] = TRIGRAM_ANCHOR;
+    padded[length++] = TRIGRAM_ANCHOR;
+    size_t nameLength = strlen(name);
+    if(nameLength > (size_t)size - 3){
+        nameLength = size - 3;
+    }
+    foldCopy(padded + length, name, nameLength);
+    length += nameLength;
+    padded[length] = '\0';
+    return length;
+}
+
+struct PostingList* findPostingList(int trigram){
+    if(trigramIndex.capacity == 0){
+        return NULL;
+    }
+    unsigned int hash = hashInt(trigram);
+    int pos = hash & (trigramIndex.capacity - 1);
+    while(trigramIndex.slots[pos].index != -1){
+        if(trigramIndex.slots[pos].hash == hash){
+            return &postingLists[trigramIndex.slots[pos].index];
+        }
+        pos = (pos + 1) & (trigramIndex.capacity - 1);
+    }
+    return NULL;
+}
+
+struct PostingList* addPostingList(int trigram){
+    if(postingListCount == postingListCapacity){
+        int capacity = postingListCapacity ? postingListCapacity * 2 : 256;
+        struct PostingList* temp = (struct PostingList*)realloc(postingLists, capacity * sizeof(struct PostingList));
+        if(temp == NULL){
+            fprintf(stderr, "Memory reallocation failed\n");
+            return NULL;
+        }
+        postingLists = temp;
+        postingListCapacity = capacity;
+    }
+    struct PostingList* list = &postingLists[postingListCount];
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    if(!insertHashIndex(&trigramIndex, hashInt(trigram), postingListCount)){
+        return NULL;
+    }
+    postingListCount++;
+    return list;
+}
+
+// Returns 0 if memory ran out, leaving the name only partly indexed.
+int insertTrigrams(int index){
+    // names have no length limit, so long ones get a buffer of their own
+    char buffer[64];
+    const char* name = studentName(index);
+    int size = (int)strlen(name) + 3;
+    char* padded = size <= (int)sizeof(buffer) ? buffer : (char*)malloc(size);
+    if(padded == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return 0;
+    }
+    int ok = 1;
+    int length = padFoldedName(name, padded, size);
+    for(int pos = 0; pos + 3 <= length; pos++){
+        int trigram = trigramAt(padded, pos);
+        struct PostingList* list = findPostingList(trigram);
+        if(list == NULL && (list = addPostingList(trigram)) == NULL){
+            ok = 0;
+            break;
+        }
+        if(list->count > 0 && list->items[list->count - 1] == index){
+            continue; // the trigram repeats within this name
+        }
+        if(list->count == list->capacity){
+            int capacity = list->capacity ? list->capacity * 2 : 4;
+            int* temp = (int*)realloc(list->items, capacity * sizeof(int));
+            if(temp == NULL){
+                fprintf(stderr, "Memory reallocation failed\n");
+                ok = 0;
+                break;
+            }
+            list->items = temp;
+            list->capacity = capacity;
+        }
+        list->items[list->count++] = index;
+    }
+    if(padded != buffer){
+        free(padded);
+    }
+    return ok;
+}
+
+void clearTrigrams(){
+    for(int i = 0; i < postingListCount; i++){
+        free(postingLists[i].items);
+    }
+    postingListCount = 0;
+    clearHashIndex(&trigramIndex, 0);
+}
+
+// Adds students[index] to every index. Expects index to be the newest student.
+// If memory runs out part way, the partial insert is dropped by marking the indexes
+// stale, so the next query rebuilds all of them from the roster.
+void insertIndexes(int index){
+    if(indexesStale){
+        return;
+    }
+    if(!reserveScoreOrder(index + 1) ||
+       !insertHashIndex(&nameIndex, hashFoldedName(studentName(index)), index) ||
+       !insertHashIndex(&idIndex, hashInt(students[index].ID), index) ||
+       !insertTrigrams(index)){
+        indexesStale = 1;
+        return;
+    }
+    scoreOrder[index] = index;
+}
+
+int compareScoreOrder(const void* a, const void* b){
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    int scoreX = students[x].score;
+    int scoreY = students[y].score;
+    if(scoreX != scoreY){
+        return (scoreX > scoreY) - (scoreX < scoreY);
+    }
+    return (x > y) - (x < y);
+}
+
+void rebuildIndexes(){
+    indexesStale = 0;
+    clearHashIndex(&nameIndex, studentCount);
+    clearHashIndex(&idIndex, studentCount);
+    clearTrigrams();
+    for(int i = 0; i < studentCount; i++){
+        if(!insertHashIndex(&nameIndex, hashFoldedName(studentName(i)), i) ||
+           !insertHashIndex(&idIndex, hashInt(students[i].ID), i) ||
+           !insertTrigrams(i)){
+            indexesStale = 1;
+            return;
+        }
+    }
+
+    if(!reserveScoreOrder(studentCount)){
+        indexesStale = 1;
+        return;
+    }
+    for(int i = 0; i < studentCount; i++){
+        scoreOrder[i] = i;
+    }
+    qsort(scoreOrder, studentCount, sizeof(int), compareScoreOrder);
+    scoreOrderSorted = studentCount;
+}
+
+// Sorts the students appended since the last score query and merges them into the
+// sorted front of scoreOrder. Every appended position is larger than the sorted ones,
+// so on equal scores the front entry goes first and insertion order is kept.
+int ensureScoreOrder(){
+    int sorted = scoreOrderSorted;
+    int added = studentCount - sorted;
+    if(added == 0){
+        return 1;
+    }
+    qsort(scoreOrder + sorted, added, sizeof(int), compareScoreOrder);
+    int* tail = (int*)malloc(added * sizeof(int));
+    if(tail == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return 0;
+    }
+    memcpy(tail, scoreOrder + sorted, added * sizeof(int));
+
+    // merge from the back so the front entries are moved before they are overwritten
+    int i = sorted - 1;
+    int j = added - 1;
+    for(int out = studentCount - 1; j >= 0; out--){
+        if(i >= 0 && students[scoreOrder[i]].score > students[tail[j]].score){
+            scoreOrder[out] = scoreOrder[i--];
+        } else {
+            scoreOrder[out] = tail[j--];
+        }
+    }
+    free(tail);
+    scoreOrderSorted = studentCount;
+    return 1;
+}
+
+int ensureIndexes(){
+    // a roster that shrank without marking the indexes stale can't be merged into
+    if(indexesStale || scoreOrderSorted > studentCount){
+        rebuildIndexes();
+    }
+    return !indexesStale && ensureScoreOrder();
+}
+
+int compareInts(const void* a, const void* b){
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+
+void writeStudentLine(FILE* file, int i){
+    fprintf(file, "Student:%d, Name:%s, Score:%d, ID:%d\n", i, studentName(i), students[i].score, students[i].ID);
+}
+
+int syncAndClose(FILE* file){
+    int failed = fflush(file) != 0;
+#ifndef _WIN32
+    failed |= fsync(fileno(file)) != 0;
+#endif
+    failed |= fclose(file) != 0;
+    return !failed;
+}
+
+// Writes the whole roster to a temporary file and swaps it in, so a crash leaves
+// either the old or the new snapshot. The journal is folded in and removed.
+int writeSnapshot(){
+    FILE* file = fopen(SNAPSHOT_FILENAME ".tmp", "w");
+    if (file == NULL) {
+        return 0;
+    }
+    fprintf(file, "Total Students: %d\n", studentCount);
+    for(int i = 0; i < studentCount; i++){
+        writeStudentLine(file, i);
+    }
+    if (!syncAndClose(file)) {
+        remove(SNAPSHOT_FILENAME ".tmp");
+        return 0;
+    }
+#ifdef _WIN32
+    remove(SNAPSHOT_FILENAME); // rename() won't replace an existing file here
+#endif
+    if (rename(SNAPSHOT_FILENAME ".tmp", SNAPSHOT_FILENAME) != 0) {
+        return 0;
+    }
+    // journal lines numbered below the snapshot's count are skipped on replay, so a
+    // crash before this remove can't duplicate students
+    remove(JOURNAL_FILENAME);
+    snapshotCount = studentCount;
+    journalEntries = 0;
+    persistedCount = studentCount;
+    return 1;
+}
+
+// Appends the students created since the last save to the journal.
+int appendJournal(){
+    FILE* file = fopen(JOURNAL_FILENAME, "a+");
+    if (file == NULL) {
+        return 0;
+    }
+    // a crash may have left half a line behind. Close it with a '#' so replay sees it
+    // is incomplete, and start on a fresh line. A positioning call is needed between
+    // reading and writing the same stream.
+    int tornLine = fseek(file, -1, SEEK_END) == 0 && fgetc(file) != '\n';
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return 0;
+    }
+    if (tornLine) {
+        fputs("#\n", file);
+    }
+    for(int i = persistedCount; i < studentCount; i++){
+        writeStudentLine(file, i);
+    }
+    if (!syncAndClose(file)) {
+        return 0;
+    }
+    journalEntries += studentCount - persistedCount;
+    persistedCount = studentCount;
+    return 1;
+}
+
+// Saving only costs the students created since the last save, until the journal
+// outgrows the snapshot and is compacted into a new one.
+void saveContent(){
+    int pending = studentCount - persistedCount;
+    int journalLimit = snapshotCount > JOURNAL_COMPACT_MIN ? snapshotCount : JOURNAL_COMPACT_MIN;
+    int saved;
+    if (persistedCount >= 0 && pending >= 0 && journalEntries + pending <= journalLimit) {
+        saved = pending == 0 || appendJournal();
+    } else {
+        saved = writeSnapshot();
+    }
+    if (!saved) {
+        printf("Error getting a handle to save file.\n");
+    }
+}
+
+void printStudent(int i){
+    printf("Student %d, Name: %s, Score: %d, ID: %d\n", i, studentName(i), students[i].score, students[i].ID);
+}
+
+void searchStudents(char key[100]){    
+//looks the key up in the name index instead of walking the whole student array.
+int* found = NULL;  
+int arrayCounter = 0;
+int capacity = 10;  
+
+
+found = (int*)malloc(capacity * sizeof(int));
+if (found == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    return;
+}
+
+ensureIndexes();
+if (nameIndex.capacity > 0) {
+    unsigned int hash = hashFoldedName(key);
+    int pos = hash & (nameIndex.capacity - 1);
+    while (nameIndex.slots[pos].index != -1) {
+        int i = nameIndex.slots[pos].index;
+        if (nameIndex.slots[pos].hash == hash && namesEqualIgnoreCase(studentName(i), key)) {
+            if (arrayCounter >= capacity) {
+                capacity *= 2;  
+                int* temp = (int*)realloc(found, capacity * sizeof(int));  
+                if (temp == NULL) {
+                    fprintf(stderr, "Memory reallocation failed\n");
+                    free(found);
+                    return;
+                }
+                found = temp;
+            }
+            found[arrayCounter] = i;
+            arrayCounter++;
+        }
+        pos = (pos + 1) & (nameIndex.capacity - 1);
+    }
+}
+
+// probing order is not insertion order once the table has been resized
+qsort(found, arrayCounter, sizeof(int), compareInts);
+
+for (int i = 0; i < arrayCounter; i++) {  
+    printStudent(found[i]);
+}
+
+free(found);
+}
+
+// Prints every student whose name contains the key (or starts with it, with prefix set).
+// Candidates come from the shortest posting list among the key's trigrams and are then
+// checked directly, so the work follows the number of matches rather than the roster.
+void searchStudentsByPart(const char* key, int prefix){
+    size_t keyLength = strlen(key);
+    if(keyLength == 0 || !ensureIndexes()){
+        return;
+    }
+
+    char padded[128];
+    int length = padFoldedName(key, padded, sizeof(padded));
+    int first = prefix ? 0 : 2; // substring searches don't use the anchored trigrams
+    int last = prefix ? (length < 5 ? length - 3 : 2) : length - 3;
+
+    if(last < first){
+        // a one or two letter substring has no trigram, fall back to a scan
+        for(int i = 0; i < studentCount; i++){
+            if(containsIgnoreCase(studentName(i), key, keyLength)){
+                printStudent(i);
+            }
+        }
+        return;
+    }
+
+    struct PostingList* shortest = NULL;
+    for(int pos = first; pos <= last; pos++){
+        struct PostingList* list = findPostingList(trigramAt(padded, pos));
+        if(list == NULL){
+            return; // some trigram of the key appears in no name at all
+        }
+        if(shortest == NULL || list->count < shortest->count){
+            shortest = list;
+        }
+    }
+
+    for(int i = 0; i < shortest->count; i++){
+        int index = shortest->items[i];
+        int match = prefix ? startsWithIgnoreCase(studentName(index), key, keyLength)
+                           : containsIgnoreCase(studentName(index), key, keyLength);
+        if(match){
+            printStudent(index);
+        }
+    }
+}
+
+void searchScoreRange(int low, int high){
+    if(!ensureIndexes()){
+        return;
+    }
+    int end = scoreBound(studentCount, high, 0);
+    for(int pos = scoreBound(studentCount, low, 1); pos < end; pos++){
+        printStudent(scoreOrder[pos]);
+    }
+}
+
+void showTopStudents(int count){
+    if(!ensureIndexes()){
+        return;
+    }
+    for(int pos = studentCount - 1; pos >= 0 && count > 0; pos--, count--){
+        printStudent(scoreOrder[pos]);
+    }
+}
+
+void searchByID(int ID){
+    if(!ensureIndexes() || idIndex.capacity == 0){
+        return;
+    }
+    unsigned int hash = hashInt(ID);
+    int pos = hash & (idIndex.capacity - 1);
+    while(idIndex.slots[pos].index != -1){
+        int i = idIndex.slots[pos].index;
+        if(students[i].ID == ID){
+            printStudent(i);
+        }
+        pos = (pos + 1) & (idIndex.capacity - 1);
+    }
+}
+
+struct Student* reallocate_student_array(struct Student* array, int elementcount) {
+    if (elementcount == 0) {
+        free(array);
+        return NULL;
+    }
+
+    struct Student* new_array = (struct Student*)realloc(array, elementcount * sizeof(struct Student));
+    if (new_array == NULL) {
+
+        fprintf(stderr, "Memory reallocation failed\n");
+        return NULL; 
+    }
+    return new_array;
+}
+
+void releaseStudentMapping() {
+    if (studentMapping == NULL) {
+        return;
+    }
+#ifndef _WIN32
+    munmap(studentMapping, studentMappingLength);
+#endif
+    studentMapping = NULL;
+    studentMappingLength = 0;
+}
+
+// The mapping is read-only, so the records and the name pool are copied onto the
+// heap before either is changed.
+int detachStudentMapping() {
+    size_t capacity = studentCount > 16 ? (size_t)studentCount : 16;
+    struct Student* records = (struct Student*)malloc(capacity * sizeof(struct Student));
+    char* pool = (char*)malloc(namePoolLength ? namePoolLength : 1);
+    if (records == NULL || pool == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(records);
+        free(pool);
+        return 0;
+    }
+    memcpy(records, students, studentCount * sizeof(struct Student));
+    memcpy(pool, namePool, namePoolLength);
+    releaseStudentMapping();
+    students = records;
+    studentCapacity = capacity;
+    namePool = pool;
+    namePoolCapacity = namePoolLength ? namePoolLength : 1;
+    return 1;
+}
+
+// Makes room for at least `needed` students, doubling the capacity so a run of
+// appends only reallocates O(log n) times.
+int reserveStudents(size_t needed) {
+    if (studentMapping != NULL && !detachStudentMapping()) {
+        return 0;
+    }
+    if (needed <= (size_t)studentCapacity) {
+        return 1;
+    }
+    size_t capacity = studentCapacity ? (size_t)studentCapacity : 16;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    struct Student* temp = reallocate_student_array(students, capacity);
+    if (temp == NULL) {
+        return 0;
+    }
+    students = temp;
+    studentCapacity = capacity;
+    return 1;
+}
+
+unsigned int checksumBytes(unsigned int hash, const void* data, size_t length);
+
+// Rebuilds the name lookup table from the strings in the pool, sized so it ends up
+// at most a quarter full.
+int resizeNamePoolSlots(){
+    size_t strings = 0;
+    for(size_t offset = 0; offset < namePoolLength; offset += strlen(namePool + offset) + 1){
+        strings++;
+    }
+    size_t slotCount = 256;
+    while(slotCount < (strings + 1) * 4){
+        slotCount *= 2;
+    }
+    unsigned int* slots = (unsigned int*)calloc(slotCount, sizeof(unsigned int));
+    if(slots == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return 0;
+    }
+
+    namePoolStrings = 0;
+    for(size_t offset = 0; offset < namePoolLength; ){
+        const char* name = namePool + offset;
+        size_t length = strlen(name);
+        size_t pos = checksumBytes(2166136261u, name, length) & (slotCount - 1);
+        while(slots[pos] != 0 && strcmp(namePool + slots[pos] - 1, name) != 0){
+            pos = (pos + 1) & (slotCount - 1);
+        }
+        if(slots[pos] == 0){
+            slots[pos] = (unsigned int)offset + 1;
+            namePoolStrings++;
+        }
+        offset += length + 1;
+    }
+    free(namePoolSlots);
+    namePoolSlots = slots;
+    namePoolSlotCount = slotCount;
+    return 1;
+}
+
+// Returns the pool offset of name[0..length), adding it if it isn't there yet, or
+// NAME_POOL_FAILED when out of memory.
+unsigned int internName(const char* name, size_t length){
+    if(studentMapping != NULL && !detachStudentMapping()){
+        return NAME_POOL_FAILED;
+    }
+    if((namePoolStrings + 1) * 2 > namePoolSlotCount && !resizeNamePoolSlots()){
+        return NAME_POOL_FAILED;
+    }
+
+    size_t mask = namePoolSlotCount - 1;
+    size_t pos = checksumBytes(2166136261u, name, length) & mask;
+    for(; namePoolSlots[pos] != 0; pos = (pos + 1) & mask){
+        // The candidate may be shorter than name and end the pool, so find its
+        // terminator before comparing bytes
+        const char* candidate = namePool + namePoolSlots[pos] - 1;
+        const char* end = (const char*)memchr(candidate, '\0', length + 1);
+        if(end == candidate + length && memcmp(candidate, name, length) == 0){
+            return namePoolSlots[pos] - 1;
+        }
+    }
+
+    if(namePoolLength + length + 1 >= NAME_POOL_FAILED){
+        return NAME_POOL_FAILED;
+    }
+    if(namePoolLength + length + 1 > namePoolCapacity){
+        size_t capacity = namePoolCapacity ? namePoolCapacity : 4096;
+        while(capacity < namePoolLength + length + 1){
+            capacity *= 2;
+        }
+        char* temp = (char*)realloc(namePool, capacity);
+        if(temp == NULL){
+            fprintf(stderr, "Memory reallocation failed\n");
+            return NAME_POOL_FAILED;
+        }
+        namePool = temp;
+        namePoolCapacity = capacity;
+    }
+    unsigned int offset = (unsigned int)namePoolLength;
+    memcpy(namePool + offset, name, length);
+    namePool[offset + length] = '\0';
+    namePoolLength += length + 1;
+    namePoolSlots[pos] = offset + 1;
+    namePoolStrings++;
+    return offset;
+}
+
+// Empties the roster, its score column and the name pool, keeping the heap
+// allocations, so a text load rebuilds the pool from its own names only.
+void resetRoster(){
+    if(studentMapping != NULL){
+        // the records and names live in the mapping, nothing to keep
+        releaseStudentMapping();
+        students = NULL;
+        studentCapacity = 0;
+        namePool = NULL;
+        namePoolCapacity = 0;
+    }
+    studentCount = 0;
+    columnCount = 0;
+    namePoolLength = 0;
+    namePoolStrings = 0;
+    if(namePoolSlots != NULL){
+        memset(namePoolSlots, 0, namePoolSlotCount * sizeof(unsigned int));
+    }
+}
+
+int reserveColumns(int needed) {
+    if (needed <= columnCapacity) {
+        return 1;
+    }
+    int capacity = columnCapacity ? columnCapacity : 16;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    int* scores = (int*)realloc(scoreColumn, capacity * sizeof(int));
+    if (scores == NULL) {
+        fprintf(stderr, "Memory reallocation failed\n");
+        return 0;
+    }
+    scoreColumn = scores;
+    columnCapacity = capacity;
+    return 1;
+}
+
+int ensureColumns() {
+    if (columnCount < studentCount) {
+        if (!reserveColumns(studentCount)) {
+            return 0;
+        }
+        for (int i = columnCount; i < studentCount; i++) {
+            scoreColumn[i] = students[i].score;
+        }
+        columnCount = studentCount;
+    }
+    return 1;
+}
+
+int appendStudents(const struct Student* batch, size_t count) {
+    if (!reserveStudents(studentCount + count)) {
+        return 0;
+    }
+    memcpy(&students[studentCount], batch, count * sizeof(struct Student));
+    if (columnCount == studentCount && reserveColumns(studentCount + count)) {
+        for (size_t i = 0; i < count; i++) {
+            scoreColumn[studentCount + i] = batch[i].score;
+        }
+        columnCount += count;
+    }
+    for (size_t i = 0; i < count; i++) {
+        studentCount++;
+        insertIndexes(studentCount - 1);
+    }
+    return 1;
+}
+
+void showScoreStats(){
+    if(studentCount == 0 || !ensureColumns()){
+        printf("No students.\n");
+        return;
+    }
+    const int* scores = scoreColumn;
+    int count = studentCount;
+    long long total = 0;
+    int min = scores[0];
+    int max = scores[0];
+    for(int i = 0; i < count; i++){
+        total += scores[i];
+    }
+    for(int i = 0; i < count; i++){
+        min = scores[i] < min ? scores[i] : min;
+        max = scores[i] > max ? scores[i] : max;
+    }
+    printf("Students: %d, Mean score: %.2f, Min score: %d, Max score: %d\n", count, (double)total / count, min, max);
+}
+
+void showScoreHistogram(int buckets){
+    if(studentCount == 0 || buckets <= 0 || !ensureColumns()){
+        printf("No students.\n");
+        return;
+    }
+    const int* scores = scoreColumn;
+    int count = studentCount;
+    int min = scores[0];
+    int max = scores[0];
+    for(int i = 0; i < count; i++){
+        min = scores[i] < min ? scores[i] : min;
+        max = scores[i] > max ? scores[i] : max;
+    }
+
+    long long span = (long long)max - min + 1;
+    if(buckets > span){
+        buckets = (int)span;
+    }
+    long* counts = (long*)calloc(buckets, sizeof(long));
+    if(counts == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    for(int i = 0; i < count; i++){
+        counts[((long long)scores[i] - min) * buckets / span]++;
+    }
+    for(int b = 0; b < buckets; b++){
+        long long low = min + span * b / buckets;
+        long long high = min + span * (b + 1) / buckets - 1;
+        printf("%lld-%lld: %ld\n", low, high, counts[b]);
+    }
+    free(counts);
+}
+
+// Nearest-rank percentile, found with quickselect on a copy of the score column.
+void showScorePercentile(double percent){
+    // written so NaN fails the check too
+    if(!(percent >= 0 && percent <= 100)){
+        printf("Percentile must be between 0 and 100.\n");
+        return;
+    }
+    if(studentCount == 0 || !ensureColumns()){
+        printf("No students.\n");
+        return;
+    }
+    int count = studentCount;
+    int* scores = (int*)malloc(count * sizeof(int));
+    if(scores == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    memcpy(scores, scoreColumn, count * sizeof(int));
+
+    int rank = (int)ceil(percent / 100.0 * count);
+    if(rank < 1) rank = 1;
+    if(rank > count) rank = count;
+    int target = rank - 1;
+    int low = 0;
+    int high = count - 1;
+    while(low < high){
+        int pivot = scores[low + (high - low) / 2];
+        int i = low;
+        int j = high;
+        while(i <= j){
+            while(scores[i] < pivot) i++;
+            while(scores[j] > pivot) j--;
+            if(i <= j){
+                int temp = scores[i];
+                scores[i] = scores[j];
+                scores[j] = temp;
+                i++;
+                j--;
+            }
+        }
+        if(target <= j){
+            high = j;
+        } else if(target >= i){
+            low = i;
+        } else {
+            break;
+        }
+    }
+    printf("%.1fth percentile score: %d\n", percent, scores[target]);
+    free(scores);
+}
+
+// A record parsed from text. The name points into the text it came from and is
+// interned when the record is appended to the roster.
+struct ParsedStudent{
+    const char* name;
+    size_t nameLength;
+    int score;
+    int ID;
+};
+
+#define LOAD_BATCH_SIZE 256
+#define LOAD_CHUNK_SIZE 65536
+
+int appendParsedStudents(const struct ParsedStudent* batch, size_t count) {
+    struct Student records[LOAD_BATCH_SIZE];
+    while (count > 0) {
+        size_t n = count < LOAD_BATCH_SIZE ? count : LOAD_BATCH_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            records[i].name = internName(batch[i].name, batch[i].nameLength);
+            if (records[i].name == NAME_POOL_FAILED) {
+                return 0;
+            }
+            records[i].score = batch[i].score;
+            records[i].ID = batch[i].ID;
+        }
+        if (!appendStudents(records, n)) {
+            return 0;
+        }
+        batch += n;
+        count -= n;
+    }
+    return 1;
+}
+
+// The text save ends a name at the first ',' and can't read back an empty one.
+int validStudentName(const char* name, size_t length) {
+    return length > 0 && memchr(name, ',', length) == NULL;
+}
+
+void createStudent(const char* name, int score, int ID) {
+    struct ParsedStudent student = {name, strlen(name), score, ID};
+    if (!validStudentName(student.name, student.nameLength)) {
+        printf("Name can't be empty or contain ','.\n");
+        return;
+    }
+    appendParsedStudents(&student, 1);
+}
+
+// Called with each batch of records parsed by streamStudentFile(). The batch, and the
+// text its names point into, is only valid for the duration of the call.
+typedef void (*StudentBatchHandler)(const struct ParsedStudent* batch, size_t count, void* context);
+
+const char* parseLiteral(const char* p, const char* end, const char* literal){
+    while (*literal) {
+        if (p == end || *p != *literal) {
+            return NULL;
+        }
+        p++;
+        literal++;
+    }
+    return p;
+}
+
+const char* parseNumber(const char* p, const char* end, int* value){
+    int negative = 0;
+    if (p != end && *p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (p == end || !isdigit((unsigned char)*p)) {
+        return NULL;
+    }
+    long long result = 0;
+    while (p != end && isdigit((unsigned char)*p)) {
+        result = result * 10 + (*p - '0');
+        if (result > 2147483648LL) {
+            return NULL;
+        }
+        p++;
+    }
+    if (!negative && result > 2147483647LL) {
+        return NULL;
+    }
+    *value = (int)(negative ? -result : result);
+    return p;
+}
+
+// Parses one "Student:%d, Name:%s, Score:%d, ID:%d" line in [p, end) without sscanf.
+int parseStudentLine(const char* p, const char* end, struct ParsedStudent* student, int* studentNumber){
+    int number;
+    p = parseLiteral(p, end, "Student:");
+    if (p == NULL || (p = parseNumber(p, end, studentNumber ? studentNumber : &number)) == NULL) {
+        return 0;
+    }
+    p = parseLiteral(p, end, ", Name:");
+    if (p == NULL) {
+        return 0;
+    }
+    const char* name = p;
+    while (p != end && *p != ',') {
+        p++;
+    }
+    if (p == name) {
+        return 0;
+    }
+    student->name = name;
+    student->nameLength = p - name;
 
-char* lowerString(char* string){
-for(int i = 0; string[i]; i++){
-  string[i] = tolower(string[i]);
+    p = parseLiteral(p, end, ", Score:");
+    if (p == NULL || (p = parseNumber(p, end, &student->score)) == NULL) {
+        return 0;
+    }
+    p = parseLiteral(p, end, ", ID:");
+    if (p == NULL || parseNumber(p, end, &student->ID) == NULL) {
+        return 0;
+    }
+    return 1;
 }
 
-return string;
+// Reads a text save file in fixed-size chunks and hands the parsed records to the
+// handler in batches, so memory use does not depend on the size of the file.
+// Returns the number of record lines, counting any that don't parse, -1 if the file
+// can't be opened and -2 if the "Total Students" header is missing. The header's
+// count is not trusted for sizing.
+long streamStudentFile(const char* filename, StudentBatchHandler handler, void* context){
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char* chunk = (char*)malloc(LOAD_CHUNK_SIZE);
+    if (chunk == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        fclose(file);
+        return -1;
+    }
+
+    struct ParsedStudent batch[LOAD_BATCH_SIZE];
+    size_t batchCount = 0;
+    long records = 0;
+    int sawHeader = 0;
+    int skippingLongLine = 0;
+    size_t pending = 0; // bytes of an unfinished line carried over from the last chunk
+    int atEnd = 0;
+
+    while (!atEnd) {
+        size_t got = fread(chunk + pending, 1, LOAD_CHUNK_SIZE - pending, file);
+        size_t length = pending + got;
+        atEnd = got == 0;
+        if (atEnd && length > 0 && chunk[length - 1] != '\n') {
+            chunk[length++] = '\n'; // last line without a newline; pending < chunk size
+        }
+
+        const char* p = chunk;
+        const char* end = chunk + length;
+        const char* newline;
+        while ((newline = memchr(p, '\n', end - p)) != NULL) {
+            const char* lineEnd = newline;
+            if (lineEnd > p && lineEnd[-1] == '\r') {
+                lineEnd--;
+            }
+            if (sawHeader && (skippingLongLine || lineEnd > p)) {
+                // every record line takes a position, even one that can't be read,
+                // so the journal's numbering still lines up
+                records++;
+            }
+            if (skippingLongLine) {
+                skippingLongLine = 0;
+            } else if (!sawHeader) {
+                if (parseLiteral(p, lineEnd, "Total Students:") == NULL) {
+                    free(chunk);
+                    fclose(file);
+                    return -2;
+                }
+                sawHeader = 1;
+            } else if (parseStudentLine(p, lineEnd, &batch[batchCount], NULL)) {
+                batchCount++;
+                if (batchCount == LOAD_BATCH_SIZE) {
+                    handler(batch, batchCount, context);
+                    batchCount = 0;
+                }
+            }
+            p = newline + 1;
+        }
+        // the names point into the chunk, so hand them over before it is refilled
+        if (batchCount > 0) {
+            handler(batch, batchCount, context);
+            batchCount = 0;
+        }
+
+        pending = end - p;
+        if (pending == LOAD_CHUNK_SIZE) {
+            // a line longer than the whole chunk can't be a record, drop it
+            pending = 0;
+            skippingLongLine = 1;
+        }
+        memmove(chunk, p, pending);
+    }
 
+    free(chunk);
+    fclose(file);
+    return sawHeader ? records : -2;
 }
 
-void saveContent(){
-    FILE *fptr;
-    fptr = fopen("student_data.txt", "w");
-    if (fptr != NULL){
-    fprintf(fptr, "Total Students: %d\n", studentCount);
-    for(int i = 0; i < studentCount; i++){
-        fprintf(fptr ,"Student:%d, Name:%s, Score:%d, ID:%d\n", i, students[i].name, students[i].score, students[i].ID);
+void appendBatch(const struct ParsedStudent* batch, size_t count, void* context){
+    (void)context;
+    appendParsedStudents(batch, count);
+}
+
+// Like appendBatch, but empties the old roster and name pool before the first batch.
+// streamStudentFile only fails before handing over a batch, so a failed load leaves
+// the old roster intact.
+void appendFirstLoadBatch(const struct ParsedStudent* batch, size_t count, void* context){
+    int* poolReset = (int*)context;
+    if(!*poolReset){
+        resetRoster();
+        *poolReset = 1;
     }
-    fclose(fptr);       
-    } else {
-        printf("Error getting a handle to save file.\n");
+    appendParsedStudents(batch, count);
+}
+
+long loadContentParallel(int threads);
+int replayJournal(StudentBatchHandler handler, void* context, long* positions);
+
+// The loaders return the number of record lines in the snapshot, or -1 on failure.
+long loadSnapshotStreaming() {
+    int poolReset = 0;
+    long records = streamStudentFile(SNAPSHOT_FILENAME, appendFirstLoadBatch, &poolReset);
+    if (records == -1) {
+        printf("Error opening file!\n");
+        return -1;
+    }
+    if (records == -2) {
+        printf("Error reading total students count!\n");
+        return -1;
+    }
+    if (!poolReset) {
+        resetRoster(); // the snapshot holds no students
     }
+    return records;
+}
 
+// Replaces the roster with the snapshot and journal. Returns 0 if the snapshot
+// can't be read.
+int loadRoster(int threads) {
+    // the indexes are rebuilt in one pass on the next query instead of per record
+    indexesStale = 1;
+    long positions = threads > 1 ? loadContentParallel(threads) : loadSnapshotStreaming();
+    if (positions < 0) {
+        return 0;
+    }
 
+    snapshotCount = studentCount;
+    journalEntries = replayJournal(appendBatch, NULL, &positions);
+    // new journal lines are numbered by roster index, so if any record was dropped the
+    // next save has to write a fresh snapshot instead
+    persistedCount = positions == studentCount ? studentCount : -1;
+    return 1;
 }
 
+void loadContent() {
+    if (loadRoster(loadThreads)) {
+        printf("Successfully loaded %d students from file.\n", studentCount);
+    }
+}
 
+struct ScoreSummary{
+    long count;
+    long long total;
+    int min;
+    int max;
+};
 
+void summarizeBatch(const struct ParsedStudent* batch, size_t count, void* context){
+    struct ScoreSummary* summary = (struct ScoreSummary*)context;
+    for (size_t i = 0; i < count; i++) {
+        int score = batch[i].score;
+        if (summary->count == 0 || score < summary->min) {
+            summary->min = score;
+        }
+        if (summary->count == 0 || score > summary->max) {
+            summary->max = score;
+        }
+        summary->total += score;
+        summary->count++;
+    }
+}
 
-void searchStudents(char key[100]){    
-//add search feature that'll loop through the student array and their elements.
-int* found = NULL;  
-int arrayCounter = 0;
-int capacity = 10;  
+// Aggregates the save file (snapshot and journal) without loading it into the roster.
+void summarizeContent() {
+    struct ScoreSummary summary = {0, 0, 0, 0};
+    long records = streamStudentFile(SNAPSHOT_FILENAME, summarizeBatch, &summary);
+    if (records == -1) {
+        printf("Error opening file!\n");
+        return;
+    }
+    if (records == -2) {
+        printf("Error reading total students count!\n");
+        return;
+    }
+    replayJournal(summarizeBatch, &summary, &records);
+    if (summary.count == 0) {
+        printf("No students in file.\n");
+        return;
+    }
+    printf("Students: %ld, Average score: %.2f, Min score: %d, Max score: %d\n",
+           summary.count, (double)summary.total / summary.count, summary.min, summary.max);
+}
 
+// Parallel loader: the whole file is read into memory, cut into slices at line
+// boundaries and each slice is parsed by its own thread into a private buffer.
+// The buffers are then appended to the roster in file order, interning the names
+// while the text is still in memory.
+#define MAX_LOAD_THREADS 64
 
-found = (int*)malloc(capacity * sizeof(int));
-if (found == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    return;
+struct ParseSlice{
+    const char* begin;
+    const char* end;
+    struct ParsedStudent* records;
+    size_t count;
+    size_t capacity;
+    long lines; // record lines in the slice, including ones that don't parse
+    int failed;
+};
+
+void* parseSliceWorker(void* arg){
+    struct ParseSlice* slice = (struct ParseSlice*)arg;
+    const char* p = slice->begin;
+    while (p < slice->end) {
+        const char* newline = memchr(p, '\n', slice->end - p);
+        const char* lineEnd = newline ? newline : slice->end;
+        const char* next = newline ? newline + 1 : slice->end;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
+        if (lineEnd == p) {
+            p = next;
+            continue;
+        }
+        slice->lines++;
+
+        if (slice->count == slice->capacity) {
+            size_t capacity = slice->capacity ? slice->capacity * 2 : 1024;
+            struct ParsedStudent* temp = (struct ParsedStudent*)realloc(slice->records, capacity * sizeof(struct ParsedStudent));
+            if (temp == NULL) {
+                slice->failed = 1;
+                return NULL;
+            }
+            slice->records = temp;
+            slice->capacity = capacity;
+        }
+        if (parseStudentLine(p, lineEnd, &slice->records[slice->count], NULL)) {
+            slice->count++;
+        }
+        p = next;
+    }
+    return NULL;
+}
+
+char* readWholeFile(const char* filename, size_t* length){
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(file);
+        return NULL;
+    }
+    char* text = (char*)malloc(size + 1);
+    if (text == NULL) {
+        fclose(file);
+        return NULL;
+    }
+    *length = fread(text, 1, size, file);
+    text[*length] = '\0';
+    fclose(file);
+    return text;
 }
 
-for (int i = 0; i < studentCount; i++) {
-        char tempName[100];
-        strncpy(tempName, students[i].name, sizeof(tempName));
-        tempName[sizeof(tempName) - 1] = '\0';
+// Splits the records after the header line into `threads` slices and parses them
+// concurrently. Returns the number of records, or -1 if a worker ran out of memory.
+long parseStudentText(const char* text, size_t length, int threads, struct ParseSlice* slices){
+    const char* end = text + length;
+    const char* body = memchr(text, '\n', length);
+    body = body ? body + 1 : end;
 
-        if (strcmp(lowerString(tempName), lowerString(key)) == 0) {
-            if (arrayCounter >= capacity) {
-                capacity *= 2;  
-                found = (int*)realloc(found, capacity * sizeof(int));  
-                if (found == NULL) {
-                    fprintf(stderr, "Memory reallocation failed\n");
-                    return;
-                }
+    const char* start = body;
+    for (int t = 0; t < threads; t++) {
+        const char* cut = t == threads - 1 ? end : body + (end - body) * (t + 1) / threads;
+        if (cut < start) {
+            cut = start;
+        }
+        if (cut < end && cut > start) {
+            // move the cut forward to just past the next newline
+            const char* newline = memchr(cut - 1, '\n', end - cut + 1);
+            cut = newline ? newline + 1 : end;
+        }
+        slices[t].begin = start;
+        slices[t].end = cut;
+        slices[t].records = NULL;
+        slices[t].count = 0;
+        slices[t].capacity = 0;
+        slices[t].lines = 0;
+        slices[t].failed = 0;
+        start = cut;
+    }
+
+    pthread_t workers[MAX_LOAD_THREADS];
+    int started[MAX_LOAD_THREADS];
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, parseSliceWorker, &slices[t]) == 0;
+        if (!started[t]) {
+            parseSliceWorker(&slices[t]);
+        }
+    }
+    parseSliceWorker(&slices[0]); // the calling thread takes the first slice
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+
+    long total = 0;
+    for (int t = 0; t < threads; t++) {
+        if (slices[t].failed) {
+            total = -1;
+        } else if (total >= 0) {
+            total += slices[t].count;
+        }
+    }
+    return total;
+}
+
+void freeParseSlices(struct ParseSlice* slices, int threads){
+    for (int t = 0; t < threads; t++) {
+        free(slices[t].records);
+    }
+}
+
+long loadContentParallel(int threads) {
+    size_t length;
+    char* text = readWholeFile(SNAPSHOT_FILENAME, &length);
+    if (text == NULL) {
+        printf("Error opening file!\n");
+        return -1;
+    }
+    if (strncmp(text, "Total Students:", 15) != 0) {
+        printf("Error reading total students count!\n");
+        free(text);
+        return -1;
+    }
+
+    struct ParseSlice slices[MAX_LOAD_THREADS];
+    long total = parseStudentText(text, length, threads, slices);
+    if (total < 0) {
+        printf("Failed to allocate memory for loaded students!\n");
+        freeParseSlices(slices, threads);
+        free(text);
+        return -1;
+    }
+
+    resetRoster();
+    if (!reserveStudents(total)) {
+        printf("Failed to allocate memory for loaded students!\n");
+        freeParseSlices(slices, threads);
+        free(text);
+        return -1;
+    }
+
+    long records = 0;
+    for (int t = 0; t < threads; t++) {
+        appendParsedStudents(slices[t].records, slices[t].count);
+        records += slices[t].lines;
+    }
+    freeParseSlices(slices, threads);
+    free(text);
+    return records;
+}
+
+// Applies the journal on top of the loaded snapshot. Each line carries the student's
+// position, so lines already folded into the snapshot, or left over from a crash, are
+// skipped and replay can be repeated safely. positions starts as the number of record
+// lines in the snapshot and is advanced past every journal line; it counts lines that
+// could not be read, so one bad record loses only itself. Returns the number of
+// journal lines.
+// An entry counts only if it ends in a newline straight after the ID's last digit,
+// so a line cut short by a crash (and closed with '#' by appendJournal) is rejected.
+// Entries that are incomplete or leave a gap after the snapshot are reported.
+int replayJournal(StudentBatchHandler handler, void* context, long* positions) {
+    size_t length;
+    char* text = readWholeFile(JOURNAL_FILENAME, &length);
+    if (text == NULL) {
+        return 0;
+    }
+
+    int entries = 0;
+    long skipped = 0;
+    const char* p = text;
+    const char* end = text + length;
+    while (p < end) {
+        const char* newline = memchr(p, '\n', end - p);
+        const char* lineEnd = newline ? newline : end;
+        const char* last = lineEnd;
+        if (last > p && last[-1] == '\r') {
+            last--;
+        }
+        int complete = newline != NULL && last > p && last[-1] >= '0' && last[-1] <= '9';
+        struct ParsedStudent student;
+        int number;
+        if (complete && parseStudentLine(p, last, &student, &number)) {
+            entries++;
+            if (number >= *positions) {
+                skipped += number - *positions;
+                handler(&student, 1, context);
+                *positions = number + 1L;
             }
-            found[arrayCounter] = i;
-            arrayCounter++;
+        } else if (last > p) {
+            // the position is still used up if the line at least starts with one
+            const char* numberEnd = parseLiteral(p, last, "Student:");
+            if (numberEnd != NULL && parseNumber(numberEnd, last, &number) != NULL && number >= *positions) {
+                *positions = number + 1L;
+            }
+            skipped++;
         }
+        p = newline ? newline + 1 : end;
     }
+    free(text);
+    if (skipped > 0) {
+        printf("Warning: skipped %ld incomplete or missing journal entries.\n", skipped);
+    }
+    return entries;
+}
 
-for (int i = 0; i < arrayCounter; i++) {  
-    printf("Student %d, Name: %s, Score: %d, ID: %d\n", found[i], students[found[i]].name, students[found[i]].score, students[found[i]].ID);
+double secondsNow(){
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
 }
 
+// Times a full load of student_data.txt at 1, 2, 4 and 8 threads: reading, parsing,
+// appending to the roster and building the indexes, everything the user waits for.
+// One thread is the streaming loader. The roster is left loaded.
+void benchmarkLoad() {
+    FILE* file = fopen(SNAPSHOT_FILENAME, "rb");
+    if (file == NULL) {
+        printf("Error opening file!\n");
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fclose(file);
+
+    int threadCounts[] = {1, 2, 4, 8};
+    for (int i = 0; i < 4; i++) {
+        double start = secondsNow();
+        int loaded = loadRoster(threadCounts[i]) && ensureIndexes();
+        double elapsed = secondsNow() - start;
+        if (!loaded) {
+            printf("Loading failed with %d threads!\n", threadCounts[i]);
+            continue;
+        }
+        printf("%d thread(s): %d students in %.3f s, %.1f MB/s\n", threadCounts[i], studentCount,
+               elapsed, elapsed > 0 ? length / elapsed / (1024.0 * 1024.0) : 0.0);
+    }
 }
 
-struct Student* reallocate_student_array(struct Student* array, int elementcount) {
-    if (elementcount == 0) {
-        free(array);
-        return NULL;
+// Compares the old search loop (copy, lowercase both strings byte by byte, strcmp)
+// with the folding kernel on the roster, or on synthetic names when it is small.
+void benchmarkFold() {
+    int count = studentCount >= 1000 ? studentCount : 200000;
+    char (*names)[50] = (char (*)[50])malloc(count * sizeof(*names));
+    if (names == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (studentCount >= 1000) {
+            snprintf(names[i], sizeof(names[i]), "%s", studentName(i));
+        } else {
+            snprintf(names[i], sizeof(names[i]), "Student Name Number %d", i);
+        }
+    }
+    char key[100];
+    strcpy(key, names[count / 2]);
+    for (int i = 0; key[i]; i++) {
+        key[i] = (char)toupper((unsigned char)key[i]);
     }
 
-    struct Student* new_array = (struct Student*)realloc(array, elementcount * sizeof(struct Student));
-    if (new_array == NULL) {
+    int passes = 20;
+    long matches = 0;
+    double start = secondsNow();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < count; i++) {
+            char tempName[100];
+            char tempKey[100];
+            strcpy(tempName, names[i]);
+            strcpy(tempKey, key);
+            for (int j = 0; tempName[j]; j++) tempName[j] = tolower((unsigned char)tempName[j]);
+            for (int j = 0; tempKey[j]; j++) tempKey[j] = tolower((unsigned char)tempKey[j]);
+            matches += strcmp(tempName, tempKey) == 0;
+        }
+    }
+    double oldTime = secondsNow() - start;
 
-        fprintf(stderr, "Memory reallocation failed\n");
-        return array; 
+    start = secondsNow();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < count; i++) {
+            matches += namesEqualIgnoreCase(names[i], key);
+        }
     }
-    return new_array;
+    double newTime = secondsNow() - start;
+
+    long compares = (long)passes * count;
+    printf("%ld compares (%ld matches)\n", compares, matches);
+    printf("tolower + strcmp: %.1f ns/compare\n", oldTime * 1e9 / compares);
+    printf("%s kernel: %.1f ns/compare (%.1fx)\n", foldKernelName, newTime * 1e9 / compares,
+           newTime > 0 ? oldTime / newTime : 0.0);
+    free(names);
 }
 
-void createStudent(char name[50], int score, int ID) {
-    struct Student* temp = reallocate_student_array(students, studentCount + 1);
-    if (temp != NULL) {
-        students = temp;
-        
-        strcpy(students[studentCount].name, name);
-        students[studentCount].score = score;
-        students[studentCount].ID = ID;
-        
-        studentCount++;
+// Binary save file: a fixed header followed by count raw struct Student records and
+// then the name pool. Both are written in native layout so the file can be mapped
+// and used in place.
+#define BINARY_FILENAME "student_data.bin"
+#define BINARY_MAGIC 0x54535453u // "STST"
+#define BINARY_VERSION 2
+#define BINARY_CHUNK 1024
+
+struct StudentFileHeader{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int recordSize; // sizeof(struct Student), catches layout changes
+    unsigned int count;
+    unsigned int checksum;   // FNV-1a over the record bytes and the name pool
+    unsigned int poolLength; // bytes of name pool after the records
+};
+
+unsigned int checksumBytes(unsigned int hash, const void* data, size_t length){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < length; i++){
+        hash ^= bytes[i];
+        hash *= 16777619u;
     }
+    return hash;
 }
 
-void loadContent() {
-    FILE* file = fopen("student_data.txt", "r");
+// Written to a temporary file and renamed into place, like the snapshot. A failed or
+// short write then leaves the old file alone, and a mapping of it stays valid.
+void saveBinaryContent(){
+    FILE* file = fopen(BINARY_FILENAME ".tmp", "wb");
     if (file == NULL) {
+        printf("Error getting a handle to save file.\n");
+        return;
+    }
+
+    struct StudentFileHeader header = {0};
+    header.magic = BINARY_MAGIC;
+    header.version = BINARY_VERSION;
+    header.recordSize = sizeof(struct Student);
+    header.count = studentCount;
+    header.poolLength = (unsigned int)namePoolLength;
+    header.checksum = checksumBytes(2166136261u, students, studentCount * sizeof(struct Student));
+    header.checksum = checksumBytes(header.checksum, namePool, namePoolLength);
+
+    // the records have no padding and the names are in the pool, so both go out as is
+    int written = fwrite(&header, sizeof(header), 1, file) == 1;
+    written = written && fwrite(students, sizeof(struct Student), studentCount, file) == (size_t)studentCount;
+    written = written && fwrite(namePool, 1, namePoolLength, file) == namePoolLength;
+    if (!syncAndClose(file) || !written) {
+        remove(BINARY_FILENAME ".tmp");
+        printf("Error writing the binary save file.\n");
+        return;
+    }
+#ifdef _WIN32
+    remove(BINARY_FILENAME); // rename() won't replace an existing file here
+#endif
+    if (rename(BINARY_FILENAME ".tmp", BINARY_FILENAME) != 0) {
+        remove(BINARY_FILENAME ".tmp");
+        printf("Error replacing %s.\n", BINARY_FILENAME);
+    }
+}
+
+int checkBinaryHeader(const struct StudentFileHeader* header, size_t fileSize){
+    if (header->magic != BINARY_MAGIC || header->version != BINARY_VERSION ||
+        header->recordSize != sizeof(struct Student)) {
+        printf("%s is not a compatible student file!\n", BINARY_FILENAME);
+        return 0;
+    }
+    if (fileSize < sizeof(*header) + (size_t)header->count * sizeof(struct Student) + header->poolLength) {
+        printf("%s is truncated!\n", BINARY_FILENAME);
+        return 0;
+    }
+    return 1;
+}
+
+// Opens the binary save file without parsing it. Only the header and the pool's final
+// terminator are checked, the records are paged in as they are touched; "verify"
+// checks the checksum.
+void loadBinaryContent(){
+#ifndef _WIN32
+    int fd = open(BINARY_FILENAME, O_RDONLY);
+    if (fd == -1) {
         printf("Error opening file!\n");
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(struct StudentFileHeader)) {
+        printf("Error reading %s!\n", BINARY_FILENAME);
+        close(fd);
+        return;
+    }
+    void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("Error mapping %s!\n", BINARY_FILENAME);
+        return;
     }
 
+    const struct StudentFileHeader* header = (const struct StudentFileHeader*)mapping;
+    char* pool = (char*)mapping + sizeof(*header) + (size_t)header->count * sizeof(struct Student);
+    if (!checkBinaryHeader(header, info.st_size)) {
+        munmap(mapping, info.st_size);
+        return;
+    }
+    if (header->poolLength > 0 && pool[header->poolLength - 1] != '\0') {
+        printf("%s is corrupt: unterminated name!\n", BINARY_FILENAME);
+        munmap(mapping, info.st_size);
+        return;
+    }
 
-    int total;
-    if (fscanf(file, "Total Students: %d\n", &total) != 1) {
-        printf("Error reading total students count!\n");
+    if (studentMapping != NULL) {
+        releaseStudentMapping();
+    } else {
+        free(students);
+        free(namePool);
+    }
+    studentMapping = mapping;
+    studentMappingLength = info.st_size;
+    students = (struct Student*)((char*)mapping + sizeof(struct StudentFileHeader));
+    studentCount = header->count;
+    studentCapacity = header->count;
+    namePool = pool;
+    namePoolLength = header->poolLength;
+    namePoolCapacity = header->poolLength;
+#else
+    // no mmap here, so fall back to reading the records in one go
+    FILE* file = fopen(BINARY_FILENAME, "rb");
+    if (file == NULL) {
+        printf("Error opening file!\n");
+        return;
+    }
+    struct StudentFileHeader header;
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < (long)sizeof(header) || fread(&header, sizeof(header), 1, file) != 1 ||
+        !checkBinaryHeader(&header, fileSize)) {
+        fclose(file);
+        return;
+    }
+    char* pool = (char*)malloc(header.poolLength ? header.poolLength : 1);
+    studentCount = 0;
+    if (pool == NULL || !reserveStudents(header.count)) {
+        free(pool);
         fclose(file);
+        return;
+    }
+    studentCount = fread(students, sizeof(struct Student), header.count, file);
+    size_t poolRead = fread(pool, 1, header.poolLength, file);
+    fclose(file);
+    if (poolRead != header.poolLength || (poolRead > 0 && pool[poolRead - 1] != '\0')) {
+        printf("%s is corrupt: unterminated name!\n", BINARY_FILENAME);
+        free(pool);
+        pool = NULL;
+        poolRead = 0;
+        studentCount = 0;
     }
+    free(namePool);
+    namePool = pool;
+    namePoolLength = poolRead;
+    namePoolCapacity = poolRead;
+#endif
 
+    // the lookup table is rebuilt from the new pool when a name is next added
+    free(namePoolSlots);
+    namePoolSlots = NULL;
+    namePoolSlotCount = 0;
+    namePoolStrings = 0;
 
-    struct Student* temp = reallocate_student_array(students, total);
-    if (temp == NULL) {
-        printf("Failed to allocate memory for loaded students!\n");
+    indexesStale = 1;
+    columnCount = 0;
+    persistedCount = -1;
+    printf("Successfully loaded %d students from file.\n", studentCount);
+}
+
+void verifyBinaryContent(){
+    FILE* file = fopen(BINARY_FILENAME, "rb");
+    if (file == NULL) {
+        printf("Error opening file!\n");
+        return;
+    }
+    struct StudentFileHeader header;
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < (long)sizeof(header) || fread(&header, sizeof(header), 1, file) != 1 ||
+        !checkBinaryHeader(&header, fileSize)) {
         fclose(file);
+        return;
     }
-    students = temp;
 
+    unsigned int checksum = 2166136261u;
+    char chunk[BINARY_CHUNK * sizeof(struct Student)];
+    size_t remaining = (size_t)header.count * sizeof(struct Student) + header.poolLength;
+    while (remaining > 0) {
+        size_t n = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+        if (fread(chunk, 1, n, file) != n) {
+            break;
+        }
+        checksum = checksumBytes(checksum, chunk, n);
+        remaining -= n;
+    }
+    fclose(file);
 
-    studentCount = 0;
-
+    if (remaining == 0 && checksum == header.checksum) {
+        printf("%s is intact (%u students).\n", BINARY_FILENAME, header.count);
+    } else {
+        printf("%s is corrupt: checksum mismatch!\n", BINARY_FILENAME);
+    }
+}
 
-    char line[200];  
-    while (fgets(line, sizeof(line), file) && studentCount < total) {
-        char name[50];
-        int score, id, student_num;
-        
+// Read a line of any length without its line ending into a malloc'd string,
+// NULL at end of input
+char* readLine(FILE* file){
+    size_t capacity = 128, length = 0;
+    char* line = (char*)malloc(capacity);
+    if(line == NULL){
+        return NULL;
+    }
 
-        if (sscanf(line, "Student:%d, Name:%[^,], Score:%d, ID:%d",
-                   &student_num, name, &score, &id) == 4) {
-            
+    while(fgets(line + length, (int)(capacity - length), file) != NULL){
+        length += strlen(line + length);
+        if(length > 0 && line[length - 1] == '\n') break;
+        if(length + 1 < capacity) continue; // end of input without a newline
 
-            strcpy(students[studentCount].name, name);
-            students[studentCount].score = score;
-            students[studentCount].ID = id;
-            studentCount++;
+        char* temp = (char*)realloc(line, capacity * 2);
+        if(temp == NULL){
+            free(line);
+            return NULL;
         }
+        line = temp;
+        capacity *= 2;
+    }
+    if(length == 0){
+        free(line);
+        return NULL;
     }
 
-    printf("Successfully loaded %d students from file.\n", studentCount);
-    fclose(file);
+    if(length > 0 && line[length - 1] == '\n') length--;
+    if(length > 0 && line[length - 1] == '\r') length--;
+    line[length] = '\0';
+    return line;
 }
 
 void checkInputs(char userinput[50]){
-    char student_name[50];
     int student_ID;
     int student_score;
     if(strcmp(userinput, "create") == 0){
+        int c;
+        while((c = getchar()) != '\n' && c != EOF); // rest of the command line
         printf("Enter the student's name: ");
-        scanf("%s", &student_name);
+        char* student_name = readLine(stdin);
+        if(student_name == NULL){
+            return;
+        }
         printf("Enter the student's ID: ");
-        scanf("%d", &student_ID);
+        if(scanf("%d", &student_ID) != 1){
+            printf("Invalid ID.\n");
+            free(student_name);
+            return;
+        }
         printf("Enter the student's score: ");
-        scanf("%d", &student_score);
+        if(scanf("%d", &student_score) != 1){
+            printf("Invalid score.\n");
+            free(student_name);
+            return;
+        }
         createStudent(student_name, student_score, student_ID);
+        free(student_name);
     }
     if(strcmp(userinput, "display") == 0){
         for(int i = 0; i < studentCount; i++){
-            printf("Student%d, Name: %s, Score: %d, ID: %d\n", i, students[i].name, students[i].score, students[i].ID);
+            printf("Student%d, Name: %s, Score: %d, ID: %d\n", i, studentName(i), students[i].score, students[i].ID);
         }
     }
     if(strcmp(userinput, "save") == 0){
@@ -178,38 +2044,245 @@ void checkInputs(char userinput[50]){
     if(strcmp(userinput, "load") == 0){
         loadContent();
     }
+    if(strcmp(userinput, "benchload") == 0){
+        benchmarkLoad();
+    }
+    if(strcmp(userinput, "benchfold") == 0){
+        benchmarkFold();
+    }
+    if(strcmp(userinput, "filestats") == 0){
+        summarizeContent();
+    }
+    if(strcmp(userinput, "savebin") == 0){
+        saveBinaryContent();
+    }
+    if(strcmp(userinput, "loadbin") == 0){
+        loadBinaryContent();
+    }
+    if(strcmp(userinput, "verify") == 0){
+        verifyBinaryContent();
+    }
     if(strcmp(userinput, "search") == 0){
+        char options[100];
         char key[100];
+        // the rest of the command line may hold --contains or --prefix
+        fgets(options, sizeof(options), stdin);
         printf("Enter a name to search through: ");
-        getchar();
         fgets(key, sizeof(key), stdin);
         key[strcspn(key, "\n")] = '\0';
-        searchStudents(key);
+        if (strstr(options, "--contains") != NULL) {
+            searchStudentsByPart(key, 0);
+        } else if (strstr(options, "--prefix") != NULL) {
+            searchStudentsByPart(key, 1);
+        } else {
+            searchStudents(key);
+        }
     }     
+    if(strcmp(userinput, "range") == 0){
+        int low, high;
+        printf("Enter the lowest score: ");
+        scanf("%d", &low);
+        printf("Enter the highest score: ");
+        scanf("%d", &high);
+        searchScoreRange(low, high);
+    }
+    if(strcmp(userinput, "top") == 0){
+        int count;
+        printf("How many students: ");
+        scanf("%d", &count);
+        showTopStudents(count);
+    }
+    if(strcmp(userinput, "id") == 0){
+        printf("Enter the student's ID: ");
+        scanf("%d", &student_ID);
+        searchByID(student_ID);
+    }
+    if(strcmp(userinput, "stats") == 0){
+        showScoreStats();
+    }
+    if(strcmp(userinput, "histogram") == 0){
+        int buckets;
+        printf("How many buckets: ");
+        scanf("%d", &buckets);
+        showScoreHistogram(buckets);
+    }
+    if(strcmp(userinput, "percentile") == 0){
+        double percent;
+        printf("Enter a percentile (0-100): ");
+        scanf("%lf", &percent);
+        showScorePercentile(percent);
+    }
     if(strcmp(userinput, "exit") == 0){
         printf("Exiting the program.\n");
         exit(0);
     }    
 }
 
+// Batch mode runs one command per line, taking arguments on the same line instead
+// of prompting for them:
+//   create NAME|ID|SCORE    search [--contains|--prefix] NAME    range LOW HIGH
+//   top N    id ID    histogram N    percentile P
+// Commands without arguments are the same as in the menu. Returns 0 on exit.
+int runBatchCommand(const char* command, const char* args, int lineNumber){
+    if(strcmp(command, "create") == 0){
+        struct ParsedStudent student;
+        const char* bar = strchr(args, '|');
+        if(bar == NULL || bar == args || sscanf(bar + 1, "%d|%d", &student.ID, &student.score) != 2){
+            fprintf(stderr, "line %d: expected create NAME|ID|SCORE\n", lineNumber);
+            return 1;
+        }
+        student.name = args;
+        student.nameLength = bar - args;
+        if(!validStudentName(student.name, student.nameLength)){
+            fprintf(stderr, "line %d: name can't contain ','\n", lineNumber);
+            return 1;
+        }
+        appendParsedStudents(&student, 1);
+        return 1;
+    }
+    if(strcmp(command, "search") == 0){
+        int prefix = -1;
+        if(strncmp(args, "--contains", 10) == 0){
+            prefix = 0;
+            args += 10;
+        } else if(strncmp(args, "--prefix", 8) == 0){
+            prefix = 1;
+            args += 8;
+        }
+        while(*args == ' ' || *args == '\t') args++;
+        if(prefix == -1) searchStudents((char*)args);
+        else searchStudentsByPart(args, prefix);
+        return 1;
+    }
+    if(strcmp(command, "range") == 0){
+        int low, high;
+        if(sscanf(args, "%d %d", &low, &high) == 2) searchScoreRange(low, high);
+        else fprintf(stderr, "line %d: expected range LOW HIGH\n", lineNumber);
+        return 1;
+    }
+    if(strcmp(command, "top") == 0 || strcmp(command, "id") == 0 || strcmp(command, "histogram") == 0){
+        int value;
+        if(sscanf(args, "%d", &value) != 1){
+            fprintf(stderr, "line %d: expected %s N\n", lineNumber, command);
+        } else if(command[0] == 't'){
+            showTopStudents(value);
+        } else if(command[0] == 'i'){
+            searchByID(value);
+        } else {
+            showScoreHistogram(value);
+        }
+        return 1;
+    }
+    if(strcmp(command, "percentile") == 0){
+        double percent;
+        if(sscanf(args, "%lf", &percent) == 1) showScorePercentile(percent);
+        else fprintf(stderr, "line %d: expected percentile P\n", lineNumber);
+        return 1;
+    }
+    if(strcmp(command, "exit") == 0){
+        return 0;
+    }
+    if(strcmp(command, "display") == 0 || strcmp(command, "save") == 0 || strcmp(command, "load") == 0 ||
+       strcmp(command, "benchload") == 0 || strcmp(command, "benchfold") == 0 || strcmp(command, "filestats") == 0 ||
+       strcmp(command, "savebin") == 0 || strcmp(command, "loadbin") == 0 || strcmp(command, "verify") == 0 ||
+       strcmp(command, "stats") == 0){
+        checkInputs((char*)command);
+        return 1;
+    }
+    fprintf(stderr, "line %d: unknown command %s\n", lineNumber, command);
+    return 1;
+}
 
+// Run commands from input without the menu. stdout is fully buffered so a long
+// script is written in large chunks rather than a line at a time.
+void runBatch(FILE* input){
+    // lines may be as long as the save file allows, see LOAD_CHUNK_SIZE
+    char* line = (char*)malloc(LOAD_CHUNK_SIZE);
+    int lineNumber = 0;
+    if(line == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 65536);
+    while(fgets(line, LOAD_CHUNK_SIZE, input) != NULL){
+        lineNumber++;
+        if(strchr(line, '\n') == NULL && !feof(input)){
+            fprintf(stderr, "line %d: too long\n", lineNumber);
+            int c;
+            while((c = fgetc(input)) != '\n' && c != EOF);
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        
+        char command[50];
+        int used = 0;
+        if(sscanf(line, "%49s%n", command, &used) != 1 || command[0] == '#'){
+            continue; // blank line or comment
+        }
+        const char* args = line + used;
+        while(*args == ' ' || *args == '\t') args++;
+        if(!runBatchCommand(command, args, lineNumber)){
+            break;
+        }
+    }
+    free(line);
+    fflush(stdout);
+}
 
-int main(){
+int main(int argc, char* argv[]){
 int loop = 1;
 char userinput[50];
 
 struct Student* students = (struct Student*)malloc(1 * sizeof(struct Student));
 
+selectFoldKernels();
+
+// studentmanagement [--threads N] [--batch [FILE]]
+// --threads N makes load parse the save file on N threads. That reads the whole file
+// into memory, so by default load streams it on one thread in bounded memory.
+int arg = 1;
+if(arg + 1 < argc && strcmp(argv[arg], "--threads") == 0){
+    int threads = atoi(argv[arg + 1]);
+    loadThreads = threads < 1 ? 1 : threads > MAX_LOAD_THREADS ? MAX_LOAD_THREADS : threads;
+    arg += 2;
+}
+
+// --batch [FILE] runs a command script, from stdin if no file is given
+if(arg < argc && strcmp(argv[arg], "--batch") == 0){
+    FILE* input = arg + 1 < argc ? fopen(argv[arg + 1], "r") : stdin;
+    if(input == NULL){
+        fprintf(stderr, "Could not open %s\n", argv[arg + 1]);
+        return 1;
+    }
+    runBatch(input);
+    if(input != stdin) fclose(input);
+    return 0;
+}
+
 printf("Welcome to Student Management Program!\n");
 while(loop){
 printf("create  | creates a new student\n");
 printf("display | displays students\n");
 printf("save    | saves student data to a file\n");
 printf("load    | loads data from a file\n");
-printf("search  | search the current database\n");
+printf("benchfold | times case-insensitive name compares\n");
+printf("filestats | summarizes the save file without loading it\n");
+printf("benchload | times loading the save file with 1-8 threads\n");
+printf("savebin | saves student data to the binary file\n");
+printf("loadbin | maps the binary file without parsing it\n");
+printf("verify  | checks the binary file's checksum\n");
+printf("search  | search the current database (--contains, --prefix for partial names)\n");
+printf("range   | lists students with a score in a range\n");
+printf("top     | lists the highest scoring students\n");
+printf("id      | looks a student up by ID\n");
+printf("stats   | mean, min and max score\n");
+printf("histogram | score distribution in buckets\n");
+printf("percentile | score at a given percentile\n");
 printf("exit    | exits the program\n");
 
-scanf("%s", &userinput);
+if(scanf("%49s", userinput) != 1){
+    break; // end of input
+}
 checkInputs(userinput);
 }
 
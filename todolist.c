@@ -1,38 +1,227 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
-#define MAX_NAME_LENGTH 100
-#define MAX_TASK_LENGTH 200
 #define INITIAL_CAPACITY 10
-#define DATE_FORMAT "%Y-%m-%d"
+#define DATE_CACHE_SIZE 256
+#define DEADLINE_CACHE_SIZE 4096  // Power of two
+#define DATE_TEXT_SIZE 24     // "YYYY-MM-DD", or a wider year outside 0..9999
+#define MAX_LOAD_THREADS 64
+#define OUTPUT_BUFFER_SIZE 65536
+#define TASK_FILE_MAGIC 0x4B534154u  // "TASK"
+#define TASK_FILE_VERSION 1
+#define MAX_TERM_LENGTH 32
+#define MAX_QUERY_TERMS 16
+#define POOL_FAILED UINT32_MAX
 
 typedef struct {
-    char name[MAX_NAME_LENGTH];
-    char description[MAX_TASK_LENGTH];
+    uint32_t name;         // Offsets of the task's text in its list's string pool
+    uint32_t description;
     time_t deadline;
-    int daysLeft;
     int isDone;
 } Task;
 
+// Interned strings, each stored once and NUL-terminated back to back in data.
+// slots is an open-addressing table of offset + 1 (0 for empty) used to find an
+// existing copy; it is built lazily, so a pool read from a file can be used as is.
 typedef struct {
-    Task** tasks;
+    char* data;
+    size_t length;
+    size_t capacity;
+    uint32_t* slots;
+    size_t slotCount;    // Power of two, kept at most half full
+    size_t stringCount;
+} StringPool;
+
+// Local calendar context, read once per display or query pass. It also memoizes
+// the local day number of recent deadlines and the "YYYY-MM-DD" text of recent day
+// numbers (both direct-mapped).
+typedef struct {
+    long today;       // Day number of the current local date
+    time_t midnight;  // Timestamp of today's local midnight
+    time_t cachedDeadline[DEADLINE_CACHE_SIZE];
+    long cachedDeadlineDay[DEADLINE_CACHE_SIZE];
+    long cachedDay[DATE_CACHE_SIZE];
+    char cachedText[DATE_CACHE_SIZE][DATE_TEXT_SIZE];
+} DayClock;
+
+// Tasks containing one search term, by ascending task index
+typedef struct {
+    char term[MAX_TERM_LENGTH];
+    int* tasks;
+    int count;
+    int capacity;
+} Posting;
+
+// Inverted index from the lower-cased words of task names and descriptions to
+// their postings, found through an open-addressing table kept at most half full
+typedef struct {
+    Posting* postings;
+    int postingCount;
+    int postingCapacity;
+    int* slots;     // Posting numbers, -1 for an empty slot
+    int slotCount;  // Power of two
+} TermIndex;
+
+// Tasks live in one contiguous array; a task's index is its stable handle.
+// Pending tasks are also kept in a binary min-heap ordered by deadline.
+typedef struct {
+    Task* tasks;
     int count;
     int capacity;
+    int* heap;      // Task indices, heap[0] is the pending task due first
+    int heapCount;
+    int* heapPos;   // Position of each task in heap, -1 when it is complete
+    int savedCount;          // Tasks the binary file has records for, -1 if it needs a full rewrite
+    unsigned char* isDirty;  // Per task, set when its status changed since the last save
+    int* dirtyList;          // Indices of the dirty tasks
+    int dirtyCount;
+    TermIndex terms;
+    StringPool strings;
 } TaskList;
 
+// A task parsed from text, its fields still pointing into the file buffer
+typedef struct {
+    const char* name;
+    size_t nameLength;
+    const char* description;
+    size_t descriptionLength;
+    time_t deadline;
+    int isDone;
+} ParsedTask;
+
+// One worker's share of a file being loaded in parallel
+typedef struct {
+    const char* begin;
+    const char* end;
+    ParsedTask* tasks;
+    int count;
+    int capacity;
+    int failed;
+} ParseSlice;
+
+// Binary task file: header, one fixed-width record per task, then a heap of
+// NUL-terminated strings the records point into. Fields are in native byte order.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t recordSize;  // sizeof(TaskRecord), catches layout changes
+    uint64_t heapSize;
+} TaskFileHeader;
+
+typedef struct {
+    int64_t deadline;
+    int32_t isDone;
+    uint32_t nameOffset;         // Offsets into the string heap
+    uint32_t descriptionOffset;
+    uint32_t reserved;
+} TaskRecord;
+
+// Output staged in memory and handed to the OS one chunk per write call
+typedef struct {
+    FILE* file;
+    size_t length;
+    int failed;
+    char data[OUTPUT_BUFFER_SIZE];
+} OutputBuffer;
+
+int loadThreads = 1;  // Worker threads used by loadFromFile, see --threads in main
+int autosave = 0;     // Save after every toggle
+int batchMode = 0;    // Commands come from a script, so nothing may prompt on stdin
+
 // Function declarations
 TaskList* initializeTaskList();
 void freeTaskList(TaskList* list);
+int reserveTasks(TaskList* list, int needed);
+unsigned int hashBytes(const char* bytes, size_t length);
+int resizePoolSlots(StringPool* pool);
+uint32_t internString(StringPool* pool, const char* text, size_t length);
+void freeStringPool(StringPool* pool);
+const char* taskName(const TaskList* list, const Task* task);
+const char* taskDescription(const TaskList* list, const Task* task);
+int dueBefore(const TaskList* list, int a, int b);
+void heapSet(TaskList* list, int pos, int index);
+void siftUp(TaskList* list, int pos);
+void siftDown(TaskList* list, int pos);
+void heapPush(TaskList* list, int index);
+void heapRemove(TaskList* list, int index);
+void flipTask(TaskList* list, int index);
+void rebuildDeadlineHeap(TaskList* list);
+time_t parseDate(const char* input);
+long daysFromCivil(int year, int month, int day);
+void civilFromDays(long days, int* year, int* month, int* day);
+void formatDay(long days, char* out);
+void localTime(time_t t, struct tm* result);
+void readDayClock(DayClock* clock);
+const char* deadlineText(const Task* task, DayClock* clock);
+long dayNumber(time_t t, DayClock* clock);
+int daysLeft(const Task* task, DayClock* clock);
+time_t clockMidnight(const DayClock* clock);
+void printTaskSummary(const TaskList* list, int index, DayClock* clock);
+int frontierBefore(const TaskList* list, const int* frontier, int a, int b);
+void frontierPush(const TaskList* list, int* frontier, int* count, int pos);
+int frontierPop(const TaskList* list, int* frontier, int* count);
+void showNextTasks(const TaskList* list, int n);
+int compareByDeadline(const void* a, const void* b);
+void collectDueBefore(const TaskList* list, int pos, time_t limit, int* found, int* foundCount);
+void showTasksDueBefore(const TaskList* list, time_t limit, DayClock* clock);
+int nextTerm(const char** text, char* term);
+unsigned int hashTerm(const char* term);
+Posting* findPosting(const TermIndex* index, const char* term);
+Posting* addPosting(TermIndex* index, const char* term);
+void indexTask(TaskList* list, int task);
+void buildTermIndex(TaskList* list);
+void freeTermIndex(TermIndex* index);
+int postingContains(const Posting* posting, int task, int* from);
+void findTasks(const TaskList* list, const char* query);
 time_t getDateFromUser();
 void createTask(TaskList* list);
+void createTaskFromLine(TaskList* list, const char* line);
+int addTask(TaskList* list, const char* name, const char* description, time_t deadline);
 void displayTasks(const TaskList* list);
-void toggleTask(TaskList* list);
+OutputBuffer* openOutput(FILE* file);
+int closeOutput(OutputBuffer* out);
+void outputFlush(OutputBuffer* out);
+void outputBytes(OutputBuffer* out, const char* bytes, size_t length);
+void outputString(OutputBuffer* out, const char* text);
+void outputNumber(OutputBuffer* out, long long value);
+void renderTasks(const TaskList* list, FILE* file);
+int writeTaskText(const TaskList* list, FILE* file);
+void benchmarkOutput(int count);
+int saveToBinary(TaskList* list, const char* filename);
+int writeTaskFile(const TaskList* list, const char* filename);
+int writeChangedRecords(TaskList* list, const char* filename);
+TaskList* loadFromBinary(const char* filename);
+int fileExists(const char* filename);
+int toggleTask(TaskList* list);
+int toggleTaskNumber(TaskList* list, int number);
 void saveToFile(const TaskList* list, const char* filename);
 TaskList* loadFromFile(const char* filename);
-void calculateDaysLeft(Task* task);
+char* readWholeFile(const char* filename, size_t* length);
+int isTaskHeader(const char* line, const char* lineEnd);
+int matchField(const char* line, const char* lineEnd, const char* prefix, const char** value, size_t* length);
+void* parseSliceWorker(void* arg);
+int parseTaskText(const char* text, size_t length, int threads, ParseSlice* slices);
+void freeParseSlices(ParseSlice* slices, int threads);
+double secondsNow();
+void benchmarkLoad(const char* filename);
+void benchmarkStorage(int count);
+int addSyntheticTasks(TaskList* list, int count);
+void benchmarkToggleSave(int count, int toggles);
 void clearInputBuffer();
+char* readLine(FILE* file);
+int runCommand(TaskList** list, const char* command, const char* argument);
+void runBatch(TaskList** list, FILE* input);
 
 // Initialize task list
 TaskList* initializeTaskList() {
@@ -42,15 +231,29 @@ TaskList* initializeTaskList() {
         exit(1);
     }
     
-    list->tasks = malloc(INITIAL_CAPACITY * sizeof(Task*));
-    if (!list->tasks) {
+    list->tasks = malloc(INITIAL_CAPACITY * sizeof(Task));
+    list->heap = malloc(INITIAL_CAPACITY * sizeof(int));
+    list->heapPos = malloc(INITIAL_CAPACITY * sizeof(int));
+    list->isDirty = calloc(INITIAL_CAPACITY, 1);
+    list->dirtyList = malloc(INITIAL_CAPACITY * sizeof(int));
+    if (!list->tasks || !list->heap || !list->heapPos || !list->isDirty || !list->dirtyList) {
         fprintf(stderr, "Memory allocation failed for tasks array\n");
+        free(list->tasks);
+        free(list->heap);
+        free(list->heapPos);
+        free(list->isDirty);
+        free(list->dirtyList);
         free(list);
         exit(1);
     }
     
     list->count = 0;
     list->capacity = INITIAL_CAPACITY;
+    list->heapCount = 0;
+    list->savedCount = -1;
+    list->dirtyCount = 0;
+    memset(&list->terms, 0, sizeof(list->terms));
+    memset(&list->strings, 0, sizeof(list->strings));
     return list;
 }
 
@@ -58,13 +261,206 @@ TaskList* initializeTaskList() {
 void freeTaskList(TaskList* list) {
     if (!list) return;
     
-    for (int i = 0; i < list->count; i++) {
-        free(list->tasks[i]);
-    }
     free(list->tasks);
+    free(list->heap);
+    free(list->heapPos);
+    free(list->isDirty);
+    free(list->dirtyList);
+    freeTermIndex(&list->terms);
+    freeStringPool(&list->strings);
     free(list);
 }
 
+// Grow the task array to hold at least `needed` tasks
+int reserveTasks(TaskList* list, int needed) {
+    if (needed <= list->capacity) return 1;
+    
+    int capacity = list->capacity ? list->capacity : INITIAL_CAPACITY;
+    while (capacity < needed) capacity *= 2;
+    
+    Task* temp = realloc(list->tasks, capacity * sizeof(Task));
+    if (!temp) {
+        fprintf(stderr, "Memory reallocation failed\n");
+        return 0;
+    }
+    list->tasks = temp;
+    
+    int* heap = realloc(list->heap, capacity * sizeof(int));
+    if (heap) list->heap = heap;
+    int* heapPos = realloc(list->heapPos, capacity * sizeof(int));
+    if (heapPos) list->heapPos = heapPos;
+    unsigned char* isDirty = realloc(list->isDirty, capacity);
+    if (isDirty) {
+        memset(isDirty + list->capacity, 0, capacity - list->capacity);
+        list->isDirty = isDirty;
+    }
+    int* dirtyList = realloc(list->dirtyList, capacity * sizeof(int));
+    if (dirtyList) list->dirtyList = dirtyList;
+    if (!heap || !heapPos || !isDirty || !dirtyList) {
+        fprintf(stderr, "Memory reallocation failed\n");
+        return 0;
+    }
+    
+    list->capacity = capacity;
+    return 1;
+}
+
+// FNV-1a
+unsigned int hashBytes(const char* bytes, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) hash = (hash ^ (unsigned char)bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Rebuild the lookup table by walking the strings in data, sized so it is at most
+// a quarter full afterwards. Duplicates (possible in files from older versions)
+// keep their first copy.
+int resizePoolSlots(StringPool* pool) {
+    size_t strings = 0;
+    for (size_t offset = 0; offset < pool->length; offset += strlen(pool->data + offset) + 1) strings++;
+    
+    size_t slotCount = 256;
+    while (slotCount < (strings + 1) * 4) slotCount *= 2;
+    uint32_t* slots = calloc(slotCount, sizeof(uint32_t));
+    if (!slots) return 0;
+    
+    pool->stringCount = 0;
+    for (size_t offset = 0; offset < pool->length; ) {
+        const char* text = pool->data + offset;
+        size_t length = strlen(text);
+        size_t slot = hashBytes(text, length) & (slotCount - 1);
+        while (slots[slot] && strcmp(pool->data + slots[slot] - 1, text) != 0) slot = (slot + 1) & (slotCount - 1);
+        if (!slots[slot]) {
+            slots[slot] = (uint32_t)offset + 1;
+            pool->stringCount++;
+        }
+        offset += length + 1;
+    }
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slotCount = slotCount;
+    return 1;
+}
+
+// Offset of a copy of text[0..length) in the pool, adding one if there is none.
+// Returns POOL_FAILED when out of memory or past the 4 GB an offset can address.
+uint32_t internString(StringPool* pool, const char* text, size_t length) {
+    if ((pool->stringCount + 1) * 2 > pool->slotCount && !resizePoolSlots(pool)) return POOL_FAILED;
+    
+    size_t mask = pool->slotCount - 1;
+    size_t slot = hashBytes(text, length) & mask;
+    for (; pool->slots[slot]; slot = (slot + 1) & mask) {
+        // The candidate may be shorter than text and end the pool, so find its
+        // terminator before comparing bytes
+        const char* candidate = pool->data + pool->slots[slot] - 1;
+        const char* end = memchr(candidate, '\0', length + 1);
+        if (end == candidate + length && memcmp(candidate, text, length) == 0) return pool->slots[slot] - 1;
+    }
+    
+    if (pool->length + length + 1 >= POOL_FAILED) return POOL_FAILED;
+    if (pool->length + length + 1 > pool->capacity) {
+        size_t capacity = pool->capacity ? pool->capacity : 4096;
+        while (capacity < pool->length + length + 1) capacity *= 2;
+        char* data = realloc(pool->data, capacity);
+        if (!data) return POOL_FAILED;
+        pool->data = data;
+        pool->capacity = capacity;
+    }
+    
+    uint32_t offset = (uint32_t)pool->length;
+    memcpy(pool->data + offset, text, length);
+    pool->data[offset + length] = '\0';
+    pool->length += length + 1;
+    pool->slots[slot] = offset + 1;
+    pool->stringCount++;
+    return offset;
+}
+
+void freeStringPool(StringPool* pool) {
+    free(pool->data);
+    free(pool->slots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+const char* taskName(const TaskList* list, const Task* task) {
+    return list->strings.data + task->name;
+}
+
+const char* taskDescription(const TaskList* list, const Task* task) {
+    return list->strings.data + task->description;
+}
+
+// Heap order: earlier deadline first, ties broken by task number
+int dueBefore(const TaskList* list, int a, int b) {
+    time_t da = list->tasks[a].deadline;
+    time_t db = list->tasks[b].deadline;
+    return da < db || (da == db && a < b);
+}
+
+void heapSet(TaskList* list, int pos, int index) {
+    list->heap[pos] = index;
+    list->heapPos[index] = pos;
+}
+
+void siftUp(TaskList* list, int pos) {
+    int index = list->heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!dueBefore(list, index, list->heap[parent])) break;
+        heapSet(list, pos, list->heap[parent]);
+        pos = parent;
+    }
+    heapSet(list, pos, index);
+}
+
+void siftDown(TaskList* list, int pos) {
+    int index = list->heap[pos];
+    while (1) {
+        int child = 2 * pos + 1;
+        if (child >= list->heapCount) break;
+        if (child + 1 < list->heapCount && dueBefore(list, list->heap[child + 1], list->heap[child])) child++;
+        if (!dueBefore(list, list->heap[child], index)) break;
+        heapSet(list, pos, list->heap[child]);
+        pos = child;
+    }
+    heapSet(list, pos, index);
+}
+
+// Add a pending task to the deadline heap
+void heapPush(TaskList* list, int index) {
+    heapSet(list, list->heapCount++, index);
+    siftUp(list, list->heapCount - 1);
+}
+
+// Take a task out of the deadline heap, e.g. when it is completed
+void heapRemove(TaskList* list, int index) {
+    int pos = list->heapPos[index];
+    if (pos < 0) return;
+    
+    list->heapPos[index] = -1;
+    int last = list->heap[--list->heapCount];
+    if (pos == list->heapCount) return;
+    
+    heapSet(list, pos, last);
+    siftUp(list, pos);
+    siftDown(list, list->heapPos[last]);
+}
+
+// Heapify all pending tasks in O(n), used after loading
+void rebuildDeadlineHeap(TaskList* list) {
+    list->heapCount = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (list->tasks[i].isDone) {
+            list->heapPos[i] = -1;
+        } else {
+            heapSet(list, list->heapCount++, i);
+        }
+    }
+    for (int pos = list->heapCount / 2 - 1; pos >= 0; pos--) {
+        siftDown(list, pos);
+    }
+}
+
 time_t getDateFromUser() {
     int year, month, day;
     char input[20];  // Increased buffer size for safety
@@ -104,49 +500,283 @@ time_t getDateFromUser() {
             }
             printf("Invalid date format. Please use YYYY-MM-DD (e.g., 2024-12-09)\n");
         }
+        else {
+            return -1;  // End of input
+        }
     }
 }
 
-// Calculate days left
-void calculateDaysLeft(Task* task) {
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Inverse of daysFromCivil
+void civilFromDays(long days, int* year, int* month, int* day) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long dayOfEra = days - era * 146097;
+    long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long monthIndex = (5 * dayOfYear + 2) / 153;
+    *day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    *month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    *year = (int)(yearOfEra + era * 400 + (*month <= 2));
+}
+
+// Write a day number as "YYYY-MM-DD" into out (11 bytes); pure integer work, thread-safe
+void formatDay(long days, char* out) {
+    int year, month, day;
+    civilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999) {
+        snprintf(out, DATE_TEXT_SIZE, "%d-%02d-%02d", year, month, day);  // Out of range for the fixed layout
+        return;
+    }
+    out[0] = '0' + year / 1000;
+    out[1] = '0' + year / 100 % 10;
+    out[2] = '0' + year / 10 % 10;
+    out[3] = '0' + year % 10;
+    out[4] = '-';
+    out[5] = '0' + month / 10;
+    out[6] = '0' + month % 10;
+    out[7] = '-';
+    out[8] = '0' + day / 10;
+    out[9] = '0' + day % 10;
+    out[10] = '\0';
+}
+
+// Reentrant localtime
+void localTime(time_t t, struct tm* result) {
+#ifdef _WIN32
+    localtime_s(result, &t);
+#else
+    localtime_r(&t, result);
+#endif
+}
+
+// Read the clock and the local date once
+void readDayClock(DayClock* clock) {
     time_t now = time(NULL);
-    double diff = difftime(task->deadline, now);
-    task->daysLeft = (int)(diff / (24 * 60 * 60));
+    struct tm local;
+    localTime(now, &local);
+    clock->today = daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+    
+    // mktime applies the UTC offset in force at midnight, not the one in force now
+    struct tm midnight = {0};
+    midnight.tm_year = local.tm_year;
+    midnight.tm_mon = local.tm_mon;
+    midnight.tm_mday = local.tm_mday;
+    midnight.tm_isdst = -1;
+    clock->midnight = mktime(&midnight);
+    
+    for (int i = 0; i < DEADLINE_CACHE_SIZE; i++) {
+        clock->cachedDeadline[i] = now;  // A true entry, so no sentinel is needed
+        clock->cachedDeadlineDay[i] = clock->today;
+    }
+    for (int i = 0; i < DATE_CACHE_SIZE; i++) {
+        clock->cachedDay[i] = -1000000000L;  // No real deadline maps here
+    }
+}
+
+// The task's deadline as "YYYY-MM-DD", formatted once per distinct day in a pass
+const char* deadlineText(const Task* task, DayClock* clock) {
+    long day = dayNumber(task->deadline, clock);
+    int slot = (int)((unsigned long)day % DATE_CACHE_SIZE);
+    if (clock->cachedDay[slot] != day) {
+        clock->cachedDay[slot] = day;
+        formatDay(day, clock->cachedText[slot]);
+    }
+    return clock->cachedText[slot];
+}
+
+// Local day number of a timestamp, from its own local date so the UTC offset in force
+// at that time applies. Tasks share few distinct deadlines, so most lookups hit the
+// cache instead of calling localtime.
+long dayNumber(time_t t, DayClock* clock) {
+    int slot = (int)(((uint64_t)t * 0x9E3779B97F4A7C15ull) >> 32) & (DEADLINE_CACHE_SIZE - 1);
+    if (clock->cachedDeadline[slot] != t) {
+        struct tm local = {0};
+        localTime(t, &local);
+        clock->cachedDeadline[slot] = t;
+        clock->cachedDeadlineDay[slot] = daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+    }
+    return clock->cachedDeadlineDay[slot];
+}
+
+// Whole calendar days from today to the task's deadline, negative once it has passed
+int daysLeft(const Task* task, DayClock* clock) {
+    return (int)(dayNumber(task->deadline, clock) - clock->today);
+}
+
+// Timestamp of today's local midnight
+time_t clockMidnight(const DayClock* clock) {
+    return clock->midnight;
 }
 
 // Create new task
 void createTask(TaskList* list) {
-    if (list->count == list->capacity) {
-        list->capacity *= 2;
-        Task** temp = realloc(list->tasks, list->capacity * sizeof(Task*));
-        if (!temp) {
-            fprintf(stderr, "Memory reallocation failed\n");
-            return;
-        }
-        list->tasks = temp;
+    printf("Enter task name: ");
+    char* name = readLine(stdin);
+    if (!name) return;
+    
+    printf("Enter task description: ");
+    char* description = readLine(stdin);
+    if (!description) {
+        free(name);
+        return;
     }
     
-    Task* newTask = malloc(sizeof(Task));
-    if (!newTask) {
-        fprintf(stderr, "Memory allocation failed for new task\n");
+    time_t deadline = getDateFromUser();
+    if (deadline != -1 && addTask(list, name, description, deadline)) {
+        printf("Task created successfully!\n");
+    }
+    free(name);
+    free(description);
+}
+
+// Create a task from "NAME|DESCRIPTION|YYYY-MM-DD"
+void createTaskFromLine(TaskList* list, const char* line) {
+    char* name = malloc(strlen(line) + 1);
+    if (!name) {
+        fprintf(stderr, "Memory allocation failed\n");
         return;
     }
+    strcpy(name, line);
     
-    clearInputBuffer();
-    printf("Enter task name: ");
-    fgets(newTask->name, MAX_NAME_LENGTH, stdin);
-    newTask->name[strcspn(newTask->name, "\n")] = 0;
+    char* description = strchr(name, '|');
+    char* date = description ? strchr(description + 1, '|') : NULL;
+    if (!date || description == name) {
+        printf("Invalid task. Please use create NAME|DESCRIPTION|YYYY-MM-DD\n");
+        free(name);
+        return;
+    }
+    *description++ = '\0';
+    *date++ = '\0';
     
-    printf("Enter task description: ");
-    fgets(newTask->description, MAX_TASK_LENGTH, stdin);
-    newTask->description[strcspn(newTask->description, "\n")] = 0;
+    time_t deadline = parseDate(date);
+    if (deadline == -1) {
+        printf("Invalid date format. Please use YYYY-MM-DD (e.g., 2024-12-09)\n");
+    }
+    else if (addTask(list, name, description, deadline)) {
+        printf("Task created successfully!\n");
+    }
+    free(name);
+}
+
+// Append a pending task and add it to the deadline heap and the word index
+int addTask(TaskList* list, const char* name, const char* description, time_t deadline) {
+    if (!reserveTasks(list, list->count + 1)) return 0;
     
-    newTask->deadline = getDateFromUser();
+    Task* newTask = &list->tasks[list->count];
+    newTask->name = internString(&list->strings, name, strlen(name));
+    newTask->description = internString(&list->strings, description, strlen(description));
+    if (newTask->name == POOL_FAILED || newTask->description == POOL_FAILED) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 0;
+    }
+    newTask->deadline = deadline;
     newTask->isDone = 0;
-    calculateDaysLeft(newTask);
     
-    list->tasks[list->count++] = newTask;
-    printf("Task created successfully!\n");
+    list->count++;
+    heapPush(list, list->count - 1);
+    indexTask(list, list->count - 1);
+    return 1;
+}
+
+// Start buffering output for file; anything already in its stdio buffer goes first
+OutputBuffer* openOutput(FILE* file) {
+    OutputBuffer* out = malloc(sizeof(OutputBuffer));
+    if (!out) {
+        fprintf(stderr, "Memory allocation failed for output buffer\n");
+        return NULL;
+    }
+    fflush(file);
+    out->file = file;
+    out->length = 0;
+    out->failed = 0;
+    return out;
+}
+
+// Flush and release the buffer, returns 0 if any write failed
+int closeOutput(OutputBuffer* out) {
+    outputFlush(out);
+    int ok = !out->failed;
+    free(out);
+    return ok;
+}
+
+void outputFlush(OutputBuffer* out) {
+    size_t written = 0;
+    while (written < out->length && !out->failed) {
+#ifndef _WIN32
+        ssize_t n = write(fileno(out->file), out->data + written, out->length - written);
+        if (n == -1 && errno == EINTR) continue;  // Interrupted before writing anything
+#else
+        long n = (long)fwrite(out->data + written, 1, out->length - written, out->file);
+#endif
+        if (n <= 0) out->failed = 1;
+        else written += n;
+    }
+    out->length = 0;
+}
+
+void outputBytes(OutputBuffer* out, const char* bytes, size_t length) {
+    while (length > 0) {
+        if (out->length == OUTPUT_BUFFER_SIZE) outputFlush(out);
+        size_t n = OUTPUT_BUFFER_SIZE - out->length;
+        if (n > length) n = length;
+        memcpy(out->data + out->length, bytes, n);
+        out->length += n;
+        bytes += n;
+        length -= n;
+    }
+}
+
+void outputString(OutputBuffer* out, const char* text) {
+    outputBytes(out, text, strlen(text));
+}
+
+void outputNumber(OutputBuffer* out, long long value) {
+    char digits[24];
+    int pos = sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[--pos] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) digits[--pos] = '-';
+    outputBytes(out, digits + pos, sizeof(digits) - pos);
+}
+
+// Write the full task listing to file
+void renderTasks(const TaskList* list, FILE* file) {
+    OutputBuffer* out = openOutput(file);
+    if (!out) return;
+    
+    DayClock clock;
+    readDayClock(&clock);
+    outputString(out, "\n=== Tasks List ===\n");
+    for (int i = 0; i < list->count; i++) {
+        const Task* task = &list->tasks[i];
+        
+        outputString(out, "\nTask ");
+        outputNumber(out, i + 1);
+        outputString(out, ":\nName: ");
+        outputString(out, taskName(list, task));
+        outputString(out, "\nDescription: ");
+        outputString(out, taskDescription(list, task));
+        outputString(out, "\nDeadline: ");
+        outputString(out, deadlineText(task, &clock));
+        outputString(out, "\nDays Left: ");
+        outputNumber(out, daysLeft(task, &clock));
+        outputString(out, task->isDone ? "\nStatus: Complete\n---------------\n" : "\nStatus: Pending\n---------------\n");
+    }
+    closeOutput(out);
 }
 
 // Display tasks
@@ -156,40 +786,371 @@ void displayTasks(const TaskList* list) {
         return;
     }
     
-    printf("\n=== Tasks List ===\n");
-    for (int i = 0; i < list->count; i++) {
-        Task* task = list->tasks[i];
-        char dateStr[11];
-        struct tm* tm_info = localtime(&task->deadline);
-        strftime(dateStr, sizeof(dateStr), DATE_FORMAT, tm_info);
-        
-        printf("\nTask %d:\n", i + 1);
-        printf("Name: %s\n", task->name);
-        printf("Description: %s\n", task->description);
-        printf("Deadline: %s\n", dateStr);
-        printf("Days Left: %d\n", task->daysLeft);
-        printf("Status: %s\n", task->isDone ? "Complete" : "Pending");
-        printf("---------------\n");
+    renderTasks(list, stdout);
+}
+
+// Flip a task's completion status, keeping the deadline heap and the set of
+// records the next save has to write in step
+void flipTask(TaskList* list, int index) {
+    Task* task = &list->tasks[index];
+    task->isDone = !task->isDone;
+    if (task->isDone) heapRemove(list, index);
+    else heapPush(list, index);
+    
+    if (!list->isDirty[index]) {
+        list->isDirty[index] = 1;
+        list->dirtyList[list->dirtyCount++] = index;
     }
 }
 
-// Toggle task completion status
-void toggleTask(TaskList* list) {
+// Toggle task completion status, returns 1 if a task changed
+int toggleTask(TaskList* list) {
     if (list->count == 0) {
         printf("No tasks available to toggle.\n");
-        return;
+        return 0;
     }
     
     int index;
     printf("Enter task number (1-%d): ", list->count);
-    if (scanf("%d", &index) == 1 && index > 0 && index <= list->count) {
-        list->tasks[index-1]->isDone = !list->tasks[index-1]->isDone;
-        printf("Task %d marked as %s\n", index, 
-               list->tasks[index-1]->isDone ? "complete" : "pending");
+    if (scanf("%d", &index) != 1) index = 0;
+    clearInputBuffer();
+    return toggleTaskNumber(list, index);
+}
+
+// Toggle task number (1-based), returns 1 if it exists
+int toggleTaskNumber(TaskList* list, int number) {
+    if (number > 0 && number <= list->count) {
+        flipTask(list, number - 1);
+        printf("Task %d marked as %s\n", number, 
+               list->tasks[number-1].isDone ? "complete" : "pending");
+        return 1;
     } else {
         printf("Invalid task number.\n");
-        clearInputBuffer();
+        return 0;
+    }
+}
+
+// Parse a "YYYY-MM-DD" date into the timestamp of its local midnight, -1 if invalid
+time_t parseDate(const char* input) {
+    int year, month, day;
+    if (sscanf(input, "%d-%d-%d", &year, &month, &day) != 3) return -1;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return -1;
+    
+    struct tm date = {0};
+    date.tm_year = year - 1900;
+    date.tm_mon = month - 1;
+    date.tm_mday = day;
+    date.tm_isdst = -1;
+    return mktime(&date);
+}
+
+void printTaskSummary(const TaskList* list, int index, DayClock* clock) {
+    const Task* task = &list->tasks[index];
+    printf("Task %d: %s - due %s (%d days left)\n", index + 1, taskName(list, task), deadlineText(task, clock), daysLeft(task, clock));
+}
+
+// Frontier helpers for showNextTasks: a heap of positions in list->heap
+int frontierBefore(const TaskList* list, const int* frontier, int a, int b) {
+    return dueBefore(list, list->heap[frontier[a]], list->heap[frontier[b]]);
+}
+
+void frontierPush(const TaskList* list, int* frontier, int* count, int pos) {
+    int i = (*count)++;
+    frontier[i] = pos;
+    while (i > 0 && frontierBefore(list, frontier, i, (i - 1) / 2)) {
+        int parent = (i - 1) / 2;
+        int temp = frontier[i];
+        frontier[i] = frontier[parent];
+        frontier[parent] = temp;
+        i = parent;
+    }
+}
+
+int frontierPop(const TaskList* list, int* frontier, int* count) {
+    int top = frontier[0];
+    frontier[0] = frontier[--(*count)];
+    int i = 0;
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1, right = left + 1;
+        if (left < *count && frontierBefore(list, frontier, left, smallest)) smallest = left;
+        if (right < *count && frontierBefore(list, frontier, right, smallest)) smallest = right;
+        if (smallest == i) break;
+        int temp = frontier[i];
+        frontier[i] = frontier[smallest];
+        frontier[smallest] = temp;
+        i = smallest;
+    }
+    return top;
+}
+
+// Print the n pending tasks due first. Walks the deadline heap best-first with a
+// small frontier heap, so it costs O(n log n) whatever the list size.
+void showNextTasks(const TaskList* list, int n) {
+    if (n <= 0 || list->heapCount == 0) {
+        printf("No pending tasks.\n");
+        return;
+    }
+    if (n > list->heapCount) n = list->heapCount;
+    
+    int* frontier = malloc((n + 2) * sizeof(int));
+    if (!frontier) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    int frontierCount = 0;
+    frontierPush(list, frontier, &frontierCount, 0);
+    DayClock clock;
+    readDayClock(&clock);
+    
+    for (int shown = 0; shown < n; shown++) {
+        int pos = frontierPop(list, frontier, &frontierCount);
+        printTaskSummary(list, list->heap[pos], &clock);
+        if (2 * pos + 1 < list->heapCount) frontierPush(list, frontier, &frontierCount, 2 * pos + 1);
+        if (2 * pos + 2 < list->heapCount) frontierPush(list, frontier, &frontierCount, 2 * pos + 2);
+    }
+    free(frontier);
+}
+
+const TaskList* sortList;  // List whose tasks compareByDeadline orders
+
+int compareByDeadline(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return dueBefore(sortList, x, y) ? -1 : (dueBefore(sortList, y, x) ? 1 : 0);
+}
+
+// Collect the heap's tasks due before limit; subtrees whose root is due later are skipped
+void collectDueBefore(const TaskList* list, int pos, time_t limit, int* found, int* foundCount) {
+    if (pos >= list->heapCount) return;
+    int index = list->heap[pos];
+    if (list->tasks[index].deadline >= limit) return;
+    
+    found[(*foundCount)++] = index;
+    collectDueBefore(list, 2 * pos + 1, limit, found, foundCount);
+    collectDueBefore(list, 2 * pos + 2, limit, found, foundCount);
+}
+
+// Print pending tasks with a deadline before limit, soonest first, in O(k log k)
+void showTasksDueBefore(const TaskList* list, time_t limit, DayClock* clock) {
+    int* found = malloc((list->heapCount + 1) * sizeof(int));
+    if (!found) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    int foundCount = 0;
+    collectDueBefore(list, 0, limit, found, &foundCount);
+    
+    sortList = list;
+    qsort(found, foundCount, sizeof(int), compareByDeadline);
+    for (int i = 0; i < foundCount; i++) {
+        printTaskSummary(list, found[i], clock);
+    }
+    if (foundCount == 0) printf("No matching tasks.\n");
+    free(found);
+}
+
+// Read the next word (a run of letters and digits) from *text into term, lower-cased
+// and cut to MAX_TERM_LENGTH - 1 characters. Returns its length, 0 at the end of text.
+int nextTerm(const char** text, char* term) {
+    const unsigned char* p = (const unsigned char*)*text;
+    while (*p && !isalnum(*p)) p++;
+    
+    int length = 0;
+    for (; isalnum(*p); p++) {
+        if (length < MAX_TERM_LENGTH - 1) term[length++] = (char)tolower(*p);
+    }
+    term[length] = '\0';
+    *text = (const char*)p;
+    return length;
+}
+
+unsigned int hashTerm(const char* term) {
+    return hashBytes(term, strlen(term));
+}
+
+Posting* findPosting(const TermIndex* index, const char* term) {
+    if (index->slotCount == 0) return NULL;
+    
+    unsigned int mask = index->slotCount - 1;
+    for (unsigned int slot = hashTerm(term) & mask; index->slots[slot] != -1; slot = (slot + 1) & mask) {
+        Posting* posting = &index->postings[index->slots[slot]];
+        if (strcmp(posting->term, term) == 0) return posting;
+    }
+    return NULL;
+}
+
+// Add an empty posting for a term not yet in the index, NULL if out of memory
+Posting* addPosting(TermIndex* index, const char* term) {
+    if (index->postingCount == index->postingCapacity) {
+        int capacity = index->postingCapacity ? index->postingCapacity * 2 : 64;
+        Posting* postings = realloc(index->postings, capacity * sizeof(Posting));
+        if (!postings) return NULL;
+        index->postings = postings;
+        index->postingCapacity = capacity;
+    }
+    
+    if ((index->postingCount + 1) * 2 > index->slotCount) {
+        int slotCount = index->slotCount ? index->slotCount * 2 : 128;
+        int* slots = malloc(slotCount * sizeof(int));
+        if (!slots) return NULL;
+        memset(slots, -1, slotCount * sizeof(int));
+        for (int i = 0; i < index->postingCount; i++) {
+            unsigned int slot = hashTerm(index->postings[i].term) & (slotCount - 1);
+            while (slots[slot] != -1) slot = (slot + 1) & (slotCount - 1);
+            slots[slot] = i;
+        }
+        free(index->slots);
+        index->slots = slots;
+        index->slotCount = slotCount;
+    }
+    
+    unsigned int slot = hashTerm(term) & (index->slotCount - 1);
+    while (index->slots[slot] != -1) slot = (slot + 1) & (index->slotCount - 1);
+    index->slots[slot] = index->postingCount;
+    
+    Posting* posting = &index->postings[index->postingCount++];
+    strcpy(posting->term, term);
+    posting->tasks = NULL;
+    posting->count = 0;
+    posting->capacity = 0;
+    return posting;
+}
+
+// Add a task's words to the index. Tasks must be indexed in ascending order so
+// every posting stays sorted.
+void indexTask(TaskList* list, int task) {
+    const char* fields[2] = {taskName(list, &list->tasks[task]), taskDescription(list, &list->tasks[task])};
+    char term[MAX_TERM_LENGTH];
+    
+    for (int f = 0; f < 2; f++) {
+        const char* text = fields[f];
+        while (nextTerm(&text, term)) {
+            Posting* posting = findPosting(&list->terms, term);
+            if (!posting && !(posting = addPosting(&list->terms, term))) {
+                fprintf(stderr, "Memory allocation failed\n");
+                return;
+            }
+            if (posting->count > 0 && posting->tasks[posting->count - 1] == task) continue;
+            
+            if (posting->count == posting->capacity) {
+                int capacity = posting->capacity ? posting->capacity * 2 : 4;
+                int* tasks = realloc(posting->tasks, capacity * sizeof(int));
+                if (!tasks) {
+                    fprintf(stderr, "Memory reallocation failed\n");
+                    return;
+                }
+                posting->tasks = tasks;
+                posting->capacity = capacity;
+            }
+            posting->tasks[posting->count++] = task;
+        }
+    }
+}
+
+void buildTermIndex(TaskList* list) {
+    for (int i = 0; i < list->count; i++) indexTask(list, i);
+}
+
+void freeTermIndex(TermIndex* index) {
+    for (int i = 0; i < index->postingCount; i++) free(index->postings[i].tasks);
+    free(index->postings);
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+// Binary search posting->tasks[*from..] for task. Candidates arrive in ascending
+// order, so *from is advanced past everything smaller for the next call.
+int postingContains(const Posting* posting, int task, int* from) {
+    int low = *from, high = posting->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (posting->tasks[mid] < task) low = mid + 1;
+        else high = mid;
+    }
+    *from = low;
+    return low < posting->count && posting->tasks[low] == task;
+}
+
+// Print the tasks containing every word of query, soonest deadline first. The
+// shortest posting is walked and each candidate is looked up in the others, so
+// the cost depends on the postings involved rather than on the number of tasks.
+void findTasks(const TaskList* list, const char* query) {
+    const Posting* postings[MAX_QUERY_TERMS];
+    int cursors[MAX_QUERY_TERMS] = {0};
+    int termCount = 0;
+    char term[MAX_TERM_LENGTH];
+    
+    while (termCount < MAX_QUERY_TERMS && nextTerm(&query, term)) {
+        const Posting* posting = findPosting(&list->terms, term);
+        if (!posting) {
+            printf("No matching tasks.\n");
+            return;
+        }
+        postings[termCount++] = posting;
+    }
+    if (termCount == 0) {
+        printf("Usage: find WORD...\n");
+        return;
+    }
+    
+    for (int i = 1; i < termCount; i++) {
+        if (postings[i]->count < postings[0]->count) {
+            const Posting* shortest = postings[i];
+            postings[i] = postings[0];
+            postings[0] = shortest;
+        }
+    }
+    
+    int* found = malloc((postings[0]->count + 1) * sizeof(int));
+    if (!found) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    int foundCount = 0;
+    for (int i = 0; i < postings[0]->count; i++) {
+        int task = postings[0]->tasks[i];
+        int matches = 1;
+        for (int t = 1; t < termCount && matches; t++) {
+            matches = postingContains(postings[t], task, &cursors[t]);
+        }
+        if (matches) found[foundCount++] = task;
+    }
+    
+    DayClock clock;
+    readDayClock(&clock);
+    sortList = list;
+    qsort(found, foundCount, sizeof(int), compareByDeadline);
+    for (int i = 0; i < foundCount; i++) {
+        printTaskSummary(list, found[i], &clock);
     }
+    if (foundCount == 0) printf("No matching tasks.\n");
+    free(found);
+}
+
+// Write the text task format to file, returns 0 on a write error
+int writeTaskText(const TaskList* list, FILE* file) {
+    OutputBuffer* out = openOutput(file);
+    if (!out) return 0;
+    
+    outputString(out, "Total Tasks: ");
+    outputNumber(out, list->count);
+    outputString(out, "\n");
+    for (int i = 0; i < list->count; i++) {
+        const Task* task = &list->tasks[i];
+        outputString(out, "Task ");
+        outputNumber(out, i + 1);
+        outputString(out, "\nTask name: ");
+        outputString(out, taskName(list, task));
+        outputString(out, "\nTask info: ");
+        outputString(out, taskDescription(list, task));
+        outputString(out, "\nTask deadline: ");
+        outputNumber(out, (long long)task->deadline);
+        outputString(out, "\nTask isDone: ");
+        outputNumber(out, task->isDone);
+        outputString(out, "\n");
+    }
+    return closeOutput(out);
 }
 
 // Save tasks to file
@@ -200,138 +1161,851 @@ void saveToFile(const TaskList* list, const char* filename) {
         return;
     }
     
-    fprintf(file, "Total Tasks: %d\n", list->count);
-    for (int i = 0; i < list->count; i++) {
-        Task* task = list->tasks[i];
-        fprintf(file, "Task %d\n", i + 1);
-        fprintf(file, "Task name: %s\n", task->name);
-        fprintf(file, "Task info: %s\n", task->description);
-        fprintf(file, "Task deadline: %lld\n", (long long)task->deadline);  // Changed to long long
-        fprintf(file, "Task isDone: %d\n", task->isDone);
+    int ok = writeTaskText(list, file);
+    if (fclose(file) != 0 || !ok) {
+        fprintf(stderr, "Error writing tasks to file.\n");
+        return;
+    }
+    printf("Tasks saved successfully!\n");
+}
+
+// Read a whole file into a NUL-terminated buffer
+char* readWholeFile(const char* filename, size_t* length) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return NULL;
+    
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(file);
+        return NULL;
     }
     
+    char* text = malloc(size + 1);
+    if (!text) {
+        fclose(file);
+        return NULL;
+    }
+    *length = fread(text, 1, size, file);
+    text[*length] = '\0';
     fclose(file);
-    printf("Tasks saved successfully!\n");
+    return text;
+}
+
+// A record starts with a "Task <number>" line
+int isTaskHeader(const char* line, const char* lineEnd) {
+    if (lineEnd - line < 6 || strncmp(line, "Task ", 5) != 0) return 0;
+    for (const char* p = line + 5; p < lineEnd; p++) {
+        if (*p < '0' || *p > '9') return 0;
+    }
+    return 1;
+}
+
+// Point value at the rest of a "<prefix><value>" line
+int matchField(const char* line, const char* lineEnd, const char* prefix, const char** value, size_t* length) {
+    size_t prefixLength = strlen(prefix);
+    if ((size_t)(lineEnd - line) < prefixLength || strncmp(line, prefix, prefixLength) != 0) return 0;
+    
+    *value = line + prefixLength;
+    *length = lineEnd - line - prefixLength;
+    return 1;
+}
+
+// Parse the task records in one slice into the slice's own task array
+void* parseSliceWorker(void* arg) {
+    ParseSlice* slice = arg;
+    ParsedTask* task = NULL;
+    const char* p = slice->begin;
+    
+    while (p < slice->end) {
+        const char* newline = memchr(p, '\n', slice->end - p);
+        const char* lineEnd = newline ? newline : slice->end;
+        const char* next = newline ? newline + 1 : slice->end;
+        if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+        
+        if (isTaskHeader(p, lineEnd)) {
+            if (slice->count == slice->capacity) {
+                int capacity = slice->capacity ? slice->capacity * 2 : INITIAL_CAPACITY;
+                ParsedTask* temp = realloc(slice->tasks, capacity * sizeof(ParsedTask));
+                if (!temp) {
+                    slice->failed = 1;
+                    return NULL;
+                }
+                slice->tasks = temp;
+                slice->capacity = capacity;
+            }
+            
+            task = &slice->tasks[slice->count++];
+            *task = (ParsedTask){"", 0, "", 0, 0, 0};
+        }
+        else if (task) {
+            if (!matchField(p, lineEnd, "Task name: ", &task->name, &task->nameLength) &&
+                !matchField(p, lineEnd, "Task info: ", &task->description, &task->descriptionLength)) {
+                if (strncmp(p, "Task deadline: ", 15) == 0) {
+                    task->deadline = (time_t)strtoll(p + 15, NULL, 10);
+                }
+                else if (strncmp(p, "Task isDone: ", 13) == 0) {
+                    task->isDone = (int)strtol(p + 13, NULL, 10);
+                }
+            }
+        }
+        p = next;
+    }
+    return NULL;
 }
 
-// Load tasks from file
+// Split the text after the header line into slices that start on a task record,
+// parse them on `threads` threads and return the number of tasks (-1 on failure)
+int parseTaskText(const char* text, size_t length, int threads, ParseSlice* slices) {
+    const char* end = text + length;
+    const char* body = text;
+    if (strncmp(text, "Total Tasks:", 12) == 0) {
+        body = memchr(text, '\n', length);
+        body = body ? body + 1 : end;
+    }
+    
+    const char* start = body;
+    for (int t = 0; t < threads; t++) {
+        const char* cut = (t == threads - 1) ? end : body + (end - body) * (t + 1) / threads;
+        if (cut <= start) cut = start;
+        else if (cut < end) {
+            // Move the cut forward to the start of the next task record
+            const char* line = memchr(cut - 1, '\n', end - cut + 1);
+            line = line ? line + 1 : end;
+            while (line < end) {
+                const char* newline = memchr(line, '\n', end - line);
+                const char* lineEnd = newline ? newline : end;
+                if (lineEnd > line && lineEnd[-1] == '\r') lineEnd--;
+                if (isTaskHeader(line, lineEnd)) break;
+                line = newline ? newline + 1 : end;
+            }
+            cut = line;
+        }
+        
+        slices[t] = (ParseSlice){start, cut, NULL, 0, 0, 0};
+        start = cut;
+    }
+    
+    pthread_t workers[MAX_LOAD_THREADS];
+    int started[MAX_LOAD_THREADS];
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, parseSliceWorker, &slices[t]) == 0;
+        if (!started[t]) parseSliceWorker(&slices[t]);
+    }
+    parseSliceWorker(&slices[0]);  // The calling thread takes the first slice
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(workers[t], NULL);
+    }
+    
+    int total = 0;
+    for (int t = 0; t < threads; t++) {
+        if (slices[t].failed) total = -1;
+        else if (total >= 0) total += slices[t].count;
+    }
+    return total;
+}
+
+// Free the per-thread task arrays
+void freeParseSlices(ParseSlice* slices, int threads) {
+    for (int t = 0; t < threads; t++) {
+        free(slices[t].tasks);
+    }
+}
+
+// Load tasks from file, parsing slices of the file on loadThreads threads
 TaskList* loadFromFile(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
+    size_t length;
+    char* text = readWholeFile(filename, &length);
+    if (!text) {
         fprintf(stderr, "Error opening file for reading.\n");
         return NULL;
     }
     
+    if (strncmp(text, "Total Tasks:", 12) != 0) {
+        fprintf(stderr, "%s has no task count header.\n", filename);
+        free(text);
+        return NULL;
+    }
+    long expected = strtol(text + 12, NULL, 10);
+    
+    ParseSlice slices[MAX_LOAD_THREADS];
+    int total = parseTaskText(text, length, loadThreads, slices);
+    if (total >= 0 && total != expected) {
+        fprintf(stderr, "Warning: %s says %ld tasks but holds %d, loading %d.\n", filename, expected, total, total);
+    }
+    TaskList* list = total < 0 ? NULL : initializeTaskList();
+    if (!list || !reserveTasks(list, total)) {
+        fprintf(stderr, "Memory allocation failed while loading task\n");
+        freeParseSlices(slices, loadThreads);
+        freeTaskList(list);
+        free(text);
+        return NULL;
+    }
+    
+    // Merge the slices in file order, interning the text while the buffer is alive
+    for (int t = 0; t < loadThreads; t++) {
+        for (int i = 0; i < slices[t].count; i++) {
+            const ParsedTask* parsed = &slices[t].tasks[i];
+            Task* task = &list->tasks[list->count++];
+            task->name = internString(&list->strings, parsed->name, parsed->nameLength);
+            task->description = internString(&list->strings, parsed->description, parsed->descriptionLength);
+            task->deadline = parsed->deadline;
+            task->isDone = parsed->isDone;
+            if (task->name == POOL_FAILED || task->description == POOL_FAILED) {
+                fprintf(stderr, "Memory allocation failed while loading task\n");
+                freeParseSlices(slices, loadThreads);
+                freeTaskList(list);
+                free(text);
+                return NULL;
+            }
+        }
+    }
+    freeParseSlices(slices, loadThreads);
+    free(text);
+    rebuildDeadlineHeap(list);
+    buildTermIndex(list);
+    
+    printf("Tasks loaded successfully!\n");
+    return list;
+}
+
+double secondsNow() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Time the parallel parser over a task file at 1, 2, 4 and 8 threads
+void benchmarkLoad(const char* filename) {
+    size_t length;
+    char* text = readWholeFile(filename, &length);
+    if (!text) {
+        fprintf(stderr, "Error opening file for reading.\n");
+        return;
+    }
+    
+    int threadCounts[] = {1, 2, 4, 8};
+    for (int i = 0; i < 4; i++) {
+        ParseSlice slices[MAX_LOAD_THREADS];
+        double start = secondsNow();
+        int total = parseTaskText(text, length, threadCounts[i], slices);
+        double elapsed = secondsNow() - start;
+        freeParseSlices(slices, threadCounts[i]);
+        if (total < 0) {
+            printf("Parsing failed with %d threads.\n", threadCounts[i]);
+            continue;
+        }
+        printf("%d thread(s): %d tasks in %.3f s, %.1f MB/s\n", threadCounts[i], total, elapsed,
+               elapsed > 0 ? length / elapsed / (1024.0 * 1024.0) : 0.0);
+    }
+    free(text);
+}
+
+// Compare filling, scanning and freeing `count` tasks held as individually
+// malloc'd records behind a pointer array against the contiguous task array
+void benchmarkStorage(int count) {
+    double start, fillTime, scanTime, freeTime;
+    long long checksum = 0;
+    StringPool strings = {0};
+    char name[32];
+    
+    // Pointer array, one malloc per task
+    start = secondsNow();
+    Task** pointers = malloc(count * sizeof(Task*));
+    if (!pointers) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        pointers[i] = malloc(sizeof(Task));
+        if (!pointers[i]) {
+            fprintf(stderr, "Memory allocation failed\n");
+            for (int j = 0; j < i; j++) free(pointers[j]);
+            free(pointers);
+            return;
+        }
+        pointers[i]->name = internString(&strings, name, snprintf(name, sizeof(name), "Task %d", i));
+        pointers[i]->description = internString(&strings, "", 0);
+        pointers[i]->deadline = 1700000000 + (time_t)i * 60;
+        pointers[i]->isDone = i % 3 == 0;
+    }
+    fillTime = secondsNow() - start;
+    
+    start = secondsNow();
+    for (int i = 0; i < count; i++) {
+        if (!pointers[i]->isDone) checksum += pointers[i]->deadline;
+    }
+    scanTime = secondsNow() - start;
+    
+    start = secondsNow();
+    for (int i = 0; i < count; i++) free(pointers[i]);
+    free(pointers);
+    freeStringPool(&strings);
+    freeTime = secondsNow() - start;
+    printf("Pointer array: fill %.3f s, scan %.4f s, free %.3f s\n", fillTime, scanTime, freeTime);
+    
+    // Contiguous array
+    start = secondsNow();
+    TaskList* list = initializeTaskList();
+    for (int i = 0; i < count; i++) {
+        if (!reserveTasks(list, list->count + 1)) {
+            freeTaskList(list);
+            return;
+        }
+        Task* task = &list->tasks[list->count++];
+        task->name = internString(&list->strings, name, snprintf(name, sizeof(name), "Task %d", i));
+        task->description = internString(&list->strings, "", 0);
+        task->deadline = 1700000000 + (time_t)i * 60;
+        task->isDone = i % 3 == 0;
+    }
+    fillTime = secondsNow() - start;
+    
+    start = secondsNow();
+    for (int i = 0; i < list->count; i++) {
+        if (!list->tasks[i].isDone) checksum -= list->tasks[i].deadline;
+    }
+    scanTime = secondsNow() - start;
+    
+    start = secondsNow();
+    freeTaskList(list);
+    freeTime = secondsNow() - start;
+    printf("Task array:    fill %.3f s, scan %.4f s, free %.3f s\n", fillTime, scanTime, freeTime);
+    
+    if (checksum != 0) printf("Scan results differ!\n");
+}
+// Append `count` generated tasks for the benchmarks, without the heap or word index
+int addSyntheticTasks(TaskList* list, int count) {
+    if (!reserveTasks(list, list->count + count)) return 0;
+    
+    char text[64];
+    for (int i = 0; i < count; i++) {
+        Task* task = &list->tasks[list->count++];
+        task->name = internString(&list->strings, text, snprintf(text, sizeof(text), "Task name %d", i));
+        task->description = internString(&list->strings, text,
+                                         snprintf(text, sizeof(text), "Description of task number %d", i));
+        task->deadline = 1700000000 + (time_t)(i % 1000) * 86400;
+        task->isDone = i % 3 == 0;
+        if (task->name == POOL_FAILED || task->description == POOL_FAILED) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Compare tasks/sec of the buffered display and save paths against printf/fprintf
+// per field, writing `count` synthetic tasks to the null device
+void benchmarkOutput(int count) {
+#ifdef _WIN32
+    FILE* sink = fopen("NUL", "w");
+#else
+    FILE* sink = fopen("/dev/null", "w");
+#endif
+    if (!sink) {
+        fprintf(stderr, "Error opening the null device.\n");
+        return;
+    }
+    
     TaskList* list = initializeTaskList();
-    char line[256];
-    int totalTasks = 0;
+    if (!addSyntheticTasks(list, count)) {
+        freeTaskList(list);
+        fclose(sink);
+        return;
+    }
     
-    // Read total tasks
-    if (fgets(line, sizeof(line), file)) {
-        sscanf(line, "Total Tasks: %d", &totalTasks);
+    DayClock clock;
+    readDayClock(&clock);
+    double start = secondsNow();
+    for (int i = 0; i < list->count; i++) {
+        const Task* task = &list->tasks[i];
+        fprintf(sink, "\nTask %d:\n", i + 1);
+        fprintf(sink, "Name: %s\n", taskName(list, task));
+        fprintf(sink, "Description: %s\n", taskDescription(list, task));
+        fprintf(sink, "Deadline: %s\n", deadlineText(task, &clock));
+        fprintf(sink, "Days Left: %d\n", daysLeft(task, &clock));
+        fprintf(sink, "Status: %s\n", task->isDone ? "Complete" : "Pending");
+        fprintf(sink, "---------------\n");
     }
+    fflush(sink);
+    double oldDisplay = secondsNow() - start;
     
-    // Read each task
-    for (int i = 0; i < totalTasks; i++) {
-        Task* task = malloc(sizeof(Task));
-        if (!task) {
-            fprintf(stderr, "Memory allocation failed while loading task\n");
+    start = secondsNow();
+    renderTasks(list, sink);
+    double newDisplay = secondsNow() - start;
+    
+    start = secondsNow();
+    fprintf(sink, "Total Tasks: %d\n", list->count);
+    for (int i = 0; i < list->count; i++) {
+        const Task* task = &list->tasks[i];
+        fprintf(sink, "Task %d\n", i + 1);
+        fprintf(sink, "Task name: %s\n", taskName(list, task));
+        fprintf(sink, "Task info: %s\n", taskDescription(list, task));
+        fprintf(sink, "Task deadline: %lld\n", (long long)task->deadline);
+        fprintf(sink, "Task isDone: %d\n", task->isDone);
+    }
+    fflush(sink);
+    double oldSave = secondsNow() - start;
+    
+    start = secondsNow();
+    writeTaskText(list, sink);
+    double newSave = secondsNow() - start;
+    
+    printf("Display: printf %.0f tasks/s, buffered %.0f tasks/s\n", count / oldDisplay, count / newDisplay);
+    printf("Save:    fprintf %.0f tasks/s, buffered %.0f tasks/s\n", count / oldSave, count / newSave);
+    freeTaskList(list);
+    fclose(sink);
+}
+
+// Time persisting single toggles on a `count` task file: a full rewrite against
+// patching the changed record in place, averaged over `toggles` saves
+void benchmarkToggleSave(int count, int toggles) {
+    const char* filename = "benchtoggle.bin";
+    TaskList* list = initializeTaskList();
+    if (!addSyntheticTasks(list, count)) {
+        freeTaskList(list);
+        return;
+    }
+    rebuildDeadlineHeap(list);
+    
+    int fullSaves = toggles < 10 ? toggles : 10;
+    double start = secondsNow();
+    for (int i = 0; i < fullSaves; i++) {
+        if (!writeTaskFile(list, filename)) {
             freeTaskList(list);
-            fclose(file);
-            return NULL;
+            return;
         }
-        
-        // Initialize task with default values
-        memset(task, 0, sizeof(Task));
-        
-        fgets(line, sizeof(line), file); // Task number
-        
-        // Read task name
-        if (fgets(line, sizeof(line), file)) {
-            line[strcspn(line, "\n")] = 0;
-            sscanf(line, "Task name: %[^\n]", task->name);
+    }
+    double fullTime = (secondsNow() - start) / fullSaves;
+    list->savedCount = list->count;
+    list->dirtyCount = 0;
+    
+    start = secondsNow();
+    for (int i = 0; i < toggles; i++) {
+        flipTask(list, (int)(((long long)i * 7919) % count));
+        if (!writeChangedRecords(list, filename)) {
+            fprintf(stderr, "Error writing tasks to file.\n");
+            break;
         }
-        
-        // Read task info
-        if (fgets(line, sizeof(line), file)) {
-            line[strcspn(line, "\n")] = 0;
-            sscanf(line, "Task info: %[^\n]", task->description);
+    }
+    double patchTime = (secondsNow() - start) / toggles;
+    
+    TaskList* reloaded = loadFromBinary(filename);
+    if (reloaded) {
+        int same = reloaded->count == list->count;
+        for (int i = 0; same && i < list->count; i++) {
+            same = reloaded->tasks[i].isDone == list->tasks[i].isDone;
         }
-        
-        // Read deadline
-        long long timestamp;  // Use long long for timestamp
-        if (fgets(line, sizeof(line), file)) {
-            if (sscanf(line, "Task deadline: %lld", &timestamp) == 1) {
-                task->deadline = (time_t)timestamp;
-            }
+        if (!same) printf("Reloaded tasks differ!\n");
+        freeTaskList(reloaded);
+    }
+    
+    printf("Full rewrite: %.1f ms per save\n", fullTime * 1e3);
+    printf("In place:     %.1f us per save\n", patchTime * 1e6);
+    remove(filename);
+    freeTaskList(list);
+}
+
+// Save tasks to the binary task file. When the file already holds a record for
+// every task, only the records of toggled tasks are rewritten in place.
+int saveToBinary(TaskList* list, const char* filename) {
+    int saved = list->savedCount == list->count && writeChangedRecords(list, filename);
+    if (!saved) {
+        if (writeTaskFile(list, filename)) {
+            for (int i = 0; i < list->dirtyCount; i++) list->isDirty[list->dirtyList[i]] = 0;
+            list->dirtyCount = 0;
+            list->savedCount = list->count;
+            saved = 1;
+        } else {
+            list->savedCount = -1;
         }
-        
-        // Read isDone
-        if (fgets(line, sizeof(line), file)) {
-            sscanf(line, "Task isDone: %d", &task->isDone);
+    }
+    if (saved) printf("Tasks saved successfully!\n");
+    return saved;
+}
+
+// Patch the isDone field of each dirty task's record. Returns 0 without writing
+// anything if the file does not match the list, so the caller can rewrite it.
+int writeChangedRecords(TaskList* list, const char* filename) {
+    FILE* file = fopen(filename, "r+b");
+    if (!file) return 0;
+    
+    TaskFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != TASK_FILE_MAGIC ||
+        header.version != TASK_FILE_VERSION || header.recordSize != sizeof(TaskRecord) ||
+        header.count != (uint32_t)list->count) {
+        fclose(file);
+        return 0;
+    }
+    
+    int ok = 1;
+    for (int i = 0; i < list->dirtyCount && ok; i++) {
+        int index = list->dirtyList[i];
+        int32_t isDone = list->tasks[index].isDone;
+        long offset = (long)(sizeof(header) + (size_t)index * sizeof(TaskRecord) + offsetof(TaskRecord, isDone));
+        ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(&isDone, sizeof(isDone), 1, file) == 1;
+    }
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        // The file may be half patched: force the next save to rewrite it. Every
+        // task stays marked dirty, so dirtyList never holds an index twice.
+        list->savedCount = -1;
+        return 0;
+    }
+    // Writes are buffered, so nothing is known to be saved until the close succeeds
+    for (int i = 0; i < list->dirtyCount; i++) list->isDirty[list->dirtyList[i]] = 0;
+    list->dirtyCount = 0;
+    return 1;
+}
+
+// Write every task to a new binary task file. It is written beside the old one
+// and renamed over it, so a failed save leaves the old file whole.
+int writeTaskFile(const TaskList* list, const char* filename) {
+    // Records hold 32-bit heap offsets
+    if (list->strings.length >= POOL_FAILED) {
+        fprintf(stderr, "Task text too large for the binary task file.\n");
+        return 0;
+    }
+    char tempName[FILENAME_MAX];
+    if (snprintf(tempName, sizeof(tempName), "%s.tmp", filename) >= (int)sizeof(tempName)) {
+        fprintf(stderr, "Task file name too long.\n");
+        return 0;
+    }
+    FILE* file = fopen(tempName, "wb");
+    if (!file) {
+        fprintf(stderr, "Error opening file for writing.\n");
+        return 0;
+    }
+    OutputBuffer* out = openOutput(file);
+    if (!out) {
+        fclose(file);
+        remove(tempName);
+        return 0;
+    }
+    
+    // The string pool is written as the heap, so records keep their pool offsets
+    TaskFileHeader header = {TASK_FILE_MAGIC, TASK_FILE_VERSION, (uint32_t)list->count, sizeof(TaskRecord),
+                             list->strings.length};
+    outputBytes(out, (const char*)&header, sizeof(header));
+    for (int i = 0; i < list->count; i++) {
+        const Task* task = &list->tasks[i];
+        TaskRecord record = {0};
+        record.deadline = (int64_t)task->deadline;
+        record.isDone = task->isDone;
+        record.nameOffset = task->name;
+        record.descriptionOffset = task->description;
+        outputBytes(out, (const char*)&record, sizeof(record));
+    }
+    outputBytes(out, list->strings.data, list->strings.length);
+    
+    int ok = closeOutput(out);
+    if (fflush(file) != 0) ok = 0;
+    if (fclose(file) != 0) ok = 0;
+#ifdef _WIN32
+    if (ok) remove(filename);  // rename() won't replace an existing file here
+#endif
+    if (!ok || rename(tempName, filename) != 0) {
+        fprintf(stderr, "Error writing tasks to file.\n");
+        remove(tempName);
+        return 0;
+    }
+    return 1;
+}
+
+// Load tasks from the binary task file. Nothing is parsed: records are read in
+// blocks straight into the task array and the heap is read directly into the list's
+// string pool. The deadline heap and term index are rebuilt from them afterwards.
+TaskList* loadFromBinary(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Error opening file for reading.\n");
+        return NULL;
+    }
+    
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    TaskFileHeader header = {0};
+    int gotHeader = length >= (long)sizeof(header) && fseek(file, 0, SEEK_SET) == 0 &&
+                    fread(&header, sizeof(header), 1, file) == 1;
+    // Sizes are checked by subtracting from what is left, so a crafted heapSize
+    // cannot wrap a sum past the end of the file
+    uint64_t available = gotHeader ? (uint64_t)length - sizeof(header) : 0;
+    uint64_t recordBytes = (uint64_t)header.count * sizeof(TaskRecord);
+    if (!gotHeader || header.magic != TASK_FILE_MAGIC || header.version != TASK_FILE_VERSION ||
+        header.recordSize != sizeof(TaskRecord) || header.heapSize >= POOL_FAILED ||
+        header.count > INT32_MAX || recordBytes > available || header.heapSize > available - recordBytes) {
+        fprintf(stderr, "%s is not a valid task file.\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    
+    TaskList* list = initializeTaskList();
+    list->strings.data = malloc(header.heapSize ? header.heapSize : 1);
+    if (!reserveTasks(list, (int)header.count) || !list->strings.data) {
+        fprintf(stderr, "Memory allocation failed for loaded tasks\n");
+        goto fail;
+    }
+    list->strings.capacity = header.heapSize;
+    
+    TaskRecord records[1024];
+    for (uint32_t first = 0; first < header.count; ) {
+        uint32_t n = header.count - first < 1024 ? header.count - first : 1024;
+        if (fread(records, sizeof(TaskRecord), n, file) != n) {
+            fprintf(stderr, "Error reading %s.\n", filename);
+            goto fail;
         }
-        
-        calculateDaysLeft(task);  // Update days left
-        list->tasks[list->count++] = task;
+        for (uint32_t i = 0; i < n; i++) {
+            Task* task = &list->tasks[first + i];
+            task->name = records[i].nameOffset;
+            task->description = records[i].descriptionOffset;
+            task->deadline = (time_t)records[i].deadline;
+            task->isDone = records[i].isDone;
+            if (task->name >= header.heapSize || task->description >= header.heapSize) {
+                fprintf(stderr, "%s is corrupt at task %u.\n", filename, first + i + 1);
+                goto fail;
+            }
+        }
+        first += n;
     }
     
+    // Every offset below heapSize then has a terminator before the end of the heap
+    if (fread(list->strings.data, 1, header.heapSize, file) != header.heapSize) {
+        fprintf(stderr, "Error reading %s.\n", filename);
+        goto fail;
+    }
+    if (header.heapSize > 0 && list->strings.data[header.heapSize - 1] != '\0') {
+        fprintf(stderr, "%s is corrupt: unterminated string.\n", filename);
+        goto fail;
+    }
+    list->strings.length = header.heapSize;
     fclose(file);
+    
+    list->count = (int)header.count;
+    list->savedCount = list->count;
+    rebuildDeadlineHeap(list);
+    buildTermIndex(list);
     printf("Tasks loaded successfully!\n");
     return list;
+    
+fail:
+    fclose(file);
+    freeTaskList(list);
+    return NULL;
+}
+
+int fileExists(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return 0;
+    fclose(file);
+    return 1;
 }
+
 // Clear input buffer
 void clearInputBuffer() {
     int c;
     while ((c = getchar()) != '\n' && c != EOF);
 }
 
-int main() {
+// Read a line of any length without its line ending into a malloc'd string,
+// NULL at end of input
+char* readLine(FILE* file) {
+    size_t capacity = 128, length = 0;
+    char* line = malloc(capacity);
+    if (!line) return NULL;
+    
+    while (fgets(line + length, (int)(capacity - length), file)) {
+        length += strlen(line + length);
+        if (length > 0 && line[length - 1] == '\n') break;
+        if (length + 1 < capacity) continue;  // End of input without a newline
+        
+        char* temp = realloc(line, capacity * 2);
+        if (!temp) {
+            free(line);
+            return NULL;
+        }
+        line = temp;
+        capacity *= 2;
+    }
+    if (length == 0) {
+        free(line);
+        return NULL;
+    }
+    
+    if (length > 0 && line[length - 1] == '\n') length--;
+    if (length > 0 && line[length - 1] == '\r') length--;
+    line[length] = '\0';
+    return line;
+}
+
+// Run one command with the rest of its line as argument. create and toggle prompt
+// for their input when no argument is given, except in batch mode. Returns 0 for exit.
+int runCommand(TaskList** list, const char* command, const char* argument) {
+    if (strcmp(command, "create") == 0) {
+        if (argument[0]) createTaskFromLine(*list, argument);
+        else if (batchMode) printf("Usage: create NAME|DESCRIPTION|YYYY-MM-DD\n");
+        else createTask(*list);
+    }
+    else if (strcmp(command, "toggle") == 0) {
+        if (!argument[0] && batchMode) {
+            printf("Usage: toggle N\n");
+        }
+        else {
+            int toggled = argument[0] ? toggleTaskNumber(*list, atoi(argument)) : toggleTask(*list);
+            if (toggled && autosave) saveToBinary(*list, "listdata.bin");
+        }
+    }
+    else if (strcmp(command, "display") == 0) {
+        displayTasks(*list);
+    }
+    else if (strcmp(command, "next") == 0) {
+        int n = argument[0] ? atoi(argument) : 1;
+        showNextTasks(*list, n);
+    }
+    else if (strcmp(command, "overdue") == 0) {
+        DayClock clock;
+        readDayClock(&clock);
+        showTasksDueBefore(*list, clockMidnight(&clock), &clock);
+    }
+    else if (strcmp(command, "due-before") == 0) {
+        time_t limit = parseDate(argument);
+        if (limit == -1) printf("Invalid date format. Please use YYYY-MM-DD (e.g., 2024-12-09)\n");
+        else {
+            DayClock clock;
+            readDayClock(&clock);
+            showTasksDueBefore(*list, limit, &clock);
+        }
+    }
+    else if (strcmp(command, "find") == 0) {
+        findTasks(*list, argument);
+    }
+    else if (strcmp(command, "save") == 0) {
+        saveToBinary(*list, "listdata.bin");
+    }
+    else if (strcmp(command, "export") == 0) {
+        saveToFile(*list, "listdata.txt");
+    }
+    else if (strcmp(command, "load") == 0 || strcmp(command, "import") == 0) {
+        TaskList* newList;
+        if (strcmp(command, "import") == 0) {
+            newList = loadFromFile("listdata.txt");
+        }
+        else if (fileExists("listdata.bin")) {
+            newList = loadFromBinary("listdata.bin");
+        }
+        else {
+            // Lists saved before the binary format only have the text file
+            printf("listdata.bin not found, loading listdata.txt\n");
+            newList = loadFromFile("listdata.txt");
+        }
+        if (newList) {
+            freeTaskList(*list);
+            *list = newList;
+        }
+    }
+    else if (strcmp(command, "benchload") == 0) {
+        benchmarkLoad("listdata.txt");
+    }
+    else if (strcmp(command, "benchstore") == 0) {
+        benchmarkStorage(1000000);
+    }
+    else if (strcmp(command, "benchoutput") == 0) {
+        benchmarkOutput(1000000);
+    }
+    else if (strcmp(command, "benchtoggle") == 0) {
+        benchmarkToggleSave(500000, 1000);
+    }
+    else if (strcmp(command, "autosave") == 0) {
+        autosave = !autosave;
+        printf("Autosave %s\n", autosave ? "on" : "off");
+    }
+    else if (strcmp(command, "exit") == 0) {
+        return 0;
+    }
+    else {
+        printf("Invalid command. Please try again.\n");
+    }
+    return 1;
+}
+
+// Run commands read from input without the menu, with stdout fully buffered
+void runBatch(TaskList** list, FILE* input) {
+    char command[20];
+    char* line;
+    int running = 1;
+    
+    batchMode = 1;
+    setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+    while (running && (line = readLine(input))) {
+        int used = 0;
+        if (sscanf(line, "%19s%n", command, &used) == 1 && command[0] != '#') {
+            running = runCommand(list, command, line + used + strspn(line + used, " \t"));
+        }
+        free(line);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
     TaskList* taskList = initializeTaskList();
     char command[20];
+    char* line;
+    int running = 1;
+    
+    // todolist [--threads N] [--batch [FILE]]
+    // --threads N parses text imports on N threads, one by default
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "--threads") == 0) {
+        int threads = atoi(argv[arg + 1]);
+        loadThreads = threads < 1 ? 1 : (threads > MAX_LOAD_THREADS ? MAX_LOAD_THREADS : threads);
+        arg += 2;
+    }
+    
+    // --batch [FILE] runs a command script, from stdin if no file is given
+    if (arg < argc && strcmp(argv[arg], "--batch") == 0) {
+        FILE* input = arg + 1 < argc ? fopen(argv[arg + 1], "r") : stdin;
+        if (!input) {
+            fprintf(stderr, "Error opening %s.\n", argv[arg + 1]);
+            freeTaskList(taskList);
+            return 1;
+        }
+        runBatch(&taskList, input);
+        if (input != stdin) fclose(input);
+        freeTaskList(taskList);
+        return 0;
+    }
     
     printf("Welcome to TODO List Manager\n");
     
-    while (1) {
+    while (running) {
         printf("\nAvailable commands:\n");
-        printf("create  - Create a new task\n");
-        printf("toggle  - Toggle task completion\n");
+        printf("create [NAME|DESCRIPTION|YYYY-MM-DD] - Create a new task\n");
+        printf("toggle [N] - Toggle task completion\n");
         printf("display - Show all tasks\n");
+        printf("next N  - Show the N pending tasks due first\n");
+        printf("overdue - Show pending tasks past their deadline\n");
+        printf("due-before YYYY-MM-DD - Show pending tasks due before a date\n");
+        printf("find WORD... - Show tasks whose name or description has every word\n");
         printf("save    - Save tasks to file\n");
         printf("load    - Load tasks from file\n");
+        printf("export  - Save tasks as text\n");
+        printf("import  - Load tasks from text\n");
+        printf("benchload - Time loading the task file with 1-8 threads\n");
+        printf("benchstore - Time 1M tasks as a pointer array vs one task array\n");
+        printf("benchoutput - Time displaying and saving 1M tasks\n");
+        printf("benchtoggle - Time saving a toggle on 500k tasks, full vs in place\n");
+        printf("autosave - Turn saving after every toggle on or off\n");
         printf("exit    - Exit program\n");
         printf("\nEnter command: ");
         
-        scanf("%19s", command);
-        clearInputBuffer();
-        
-        if (strcmp(command, "create") == 0) {
-            createTask(taskList);
-        }
-        else if (strcmp(command, "toggle") == 0) {
-            toggleTask(taskList);
-        }
-        else if (strcmp(command, "display") == 0) {
-            displayTasks(taskList);
-        }
-        else if (strcmp(command, "save") == 0) {
-            saveToFile(taskList, "listdata.txt");
-        }
-        else if (strcmp(command, "load") == 0) {
-            TaskList* newList = loadFromFile("listdata.txt");
-            if (newList) {
-                freeTaskList(taskList);
-                taskList = newList;
-            }
-        }
-        else if (strcmp(command, "exit") == 0) {
-            break;
-        }
-        else {
-            printf("Invalid command. Please try again.\n");
+        if (!(line = readLine(stdin))) break;
+        int used = 0;
+        if (sscanf(line, "%19s%n", command, &used) == 1) {
+            running = runCommand(&taskList, command, line + used + strspn(line + used, " \t"));
         }
+        free(line);
     }
     
     freeTaskList(taskList);
     printf("Goodbye!\n");
     return 0;
-}
\ No newline at end of file
+}